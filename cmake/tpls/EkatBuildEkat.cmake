@@ -51,6 +51,7 @@ macro (BuildEkat)
     set(oneValueArgs
       PREFIX
       MPI_ERRORS_ARE_FATAL
+      MPI_GPU_AWARE
       CONSTEXPR_ASSERT
       MIMIC_GPU
       ENABLE_FPE
@@ -115,6 +116,10 @@ macro (setVars PREFIX SET_DEFAULTS)
     set (EKAT_MPI_ERRORS_ARE_FATAL ${${PREFIX}_MPI_ERRORS_ARE_FATAL} CACHE BOOL "")
   endif()
 
+  if (DEFINED ${PREFIX}_MPI_GPU_AWARE)
+    set (EKAT_MPI_GPU_AWARE ${${PREFIX}_MPI_GPU_AWARE} CACHE BOOL "")
+  endif()
+
   if (DEFINED ${PREFIX}_FPMODEL)
     set (EKAT_FPMODEL ${${PREFIX}_FPMODEL} CACHE STRING "")
   elseif (setVars_DEBUG_BUILD AND SET_DEFAULTS)
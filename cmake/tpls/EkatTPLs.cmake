@@ -33,6 +33,7 @@ if (EKAT_ENABLE_MPI)
 
   # MPI-related options
   option (EKAT_MPI_ERRORS_ARE_FATAL " Whether EKAT should crash when MPI errors happen." ON)
+  option (EKAT_MPI_GPU_AWARE "Whether the MPI library can directly access device memory." OFF)
 
 endif()
 
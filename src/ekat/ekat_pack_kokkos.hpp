@@ -7,6 +7,9 @@
 
 #include <vector>
 #include <type_traits>
+#include <algorithm>
+#include <array>
+#include <functional>
 
 namespace ekat {
 
@@ -83,82 +86,234 @@ index_and_shift (const Array1& a, const IdxPack& i0, Pack<typename Array1::non_c
   }
 }
 
-// Turn a View of Packs into a View of scalars.
-// Example: const auto b = scalarize(a);
+namespace impl {
+
+// The number of scalars in a value type (1 for scalars), and the
+// (possibly const) scalar type itself.
+template <typename T>
+struct PackTraits {
+  using scalar = T;
+  static constexpr int n = 1;
+};
+template <typename T, int N>
+struct PackTraits<Pack<T,N>> {
+  using scalar = T;
+  static constexpr int n = N;
+};
+template <typename T, int N>
+struct PackTraits<const Pack<T,N>> {
+  using scalar = const T;
+  static constexpr int n = N;
+};
+
+// Reinterpreting a view of OldN-wide packs as a view of NewN-wide packs
+// (with N=1 for scalars) only rescales the last (packed) dimension, and
+// the other strides. This is possible if the last dimension is contiguous,
+// and, if NewN>OldN, the packed extent and the other strides are divisible
+// by NewN/OldN.
+template <int OldN, int NewN, typename LayoutT>
+KOKKOS_INLINE_FUNCTION
+bool is_reinterpretable (const LayoutT& layout, const int rank) {
+  return OldN >= NewN || layout.dimension[rank-1] % (NewN/OldN) == 0;
+}
 
-// 4d
-template <typename T, typename ...Parms, int pack_size> KOKKOS_FORCEINLINE_FUNCTION
-Unmanaged<Kokkos::View<T****, Parms...> >
-scalarize (const Kokkos::View<Pack<T, pack_size>****, Parms...>& vp) {
-  return Unmanaged<Kokkos::View<T****, Parms...> >(
-    reinterpret_cast<T*>(vp.data()),
-    vp.extent_int(0), vp.extent_int(1), vp.extent_int(2),
-    pack_size * vp.extent_int(3));
+template <int OldN, int NewN>
+KOKKOS_INLINE_FUNCTION
+bool is_reinterpretable (const Kokkos::LayoutStride& layout, const int rank) {
+  if (layout.stride[rank-1]!=1) {
+    return false;
+  }
+  for (int d = 0; d < rank-1; ++d) {
+    if (OldN < NewN && layout.stride[d] % (NewN/OldN) != 0) {
+      return false;
+    }
+  }
+  return OldN >= NewN || layout.dimension[rank-1] % (NewN/OldN) == 0;
 }
 
-// 4d const
-template <typename T, typename ...Parms, int pack_size> KOKKOS_FORCEINLINE_FUNCTION
-Unmanaged<Kokkos::View<const T****, Parms...> >
-scalarize (const Kokkos::View<const Pack<T, pack_size>****, Parms...>& vp) {
-  return Unmanaged<Kokkos::View<const T****, Parms...> >(
-    reinterpret_cast<const T*>(vp.data()),
-    vp.extent_int(0), vp.extent_int(1), vp.extent_int(2),
-    pack_size * vp.extent_int(3));
+template <int OldN, int NewN, typename LayoutT>
+KOKKOS_INLINE_FUNCTION
+void rescale_packed_dim (LayoutT& layout, const int rank) {
+  auto& n = layout.dimension[rank-1];
+  n = OldN >= NewN ? n*(OldN/NewN) : n/(NewN/OldN);
 }
 
-// 3d
-template <typename T, typename ...Parms, int pack_size> KOKKOS_FORCEINLINE_FUNCTION
-Unmanaged<Kokkos::View<T***, Parms...> >
-scalarize (const Kokkos::View<Pack<T, pack_size>***, Parms...>& vp) {
-  return Unmanaged<Kokkos::View<T***, Parms...> >(
-    reinterpret_cast<T*>(vp.data()), vp.extent_int(0), vp.extent_int(1),
-    pack_size * vp.extent_int(2));
+template <int OldN, int NewN>
+KOKKOS_INLINE_FUNCTION
+void rescale_packed_dim (Kokkos::LayoutStride& layout, const int rank) {
+  for (int d = 0; d < rank; ++d) {
+    auto& n = d==rank-1 ? layout.dimension[d] : layout.stride[d];
+    n = OldN >= NewN ? n*(OldN/NewN) : n/(NewN/OldN);
+  }
 }
 
-// 3d const
-template <typename T, typename ...Parms, int pack_size> KOKKOS_FORCEINLINE_FUNCTION
-Unmanaged<Kokkos::View<const T***, Parms...> >
-scalarize (const Kokkos::View<const Pack<T, pack_size>***, Parms...>& vp) {
-  return Unmanaged<Kokkos::View<const T***, Parms...> >(
-    reinterpret_cast<const T*>(vp.data()), vp.extent_int(0), vp.extent_int(1),
-    pack_size * vp.extent_int(2));
+// Check (at compile time) that the values of ViewT can be reinterpreted as NewValueT.
+template <typename ViewT, typename NewValueT>
+struct CheckReinterpret {
+  using old_value_t = typename ViewT::traits::value_type;
+  using layout_t = typename ViewT::traits::array_layout;
+  static constexpr int rank = ViewT::Rank;
+  static constexpr int old_n = PackTraits<old_value_t>::n;
+  static constexpr int new_n = PackTraits<NewValueT>::n;
+
+  static_assert(rank>=1 && rank<=7, "Error! Only views of rank 1 through 7 are supported.\n");
+  static_assert(std::is_same<typename std::remove_const<typename PackTraits<old_value_t>::scalar>::type,
+                             typename std::remove_const<typename PackTraits<NewValueT>::scalar>::type>::value,
+                "Error! Old and new value types must have the same scalar type.\n");
+  static_assert(std::is_const<NewValueT>::value || !std::is_const<old_value_t>::value,
+                "Error! Cannot drop the const qualifier.\n");
+  static_assert(old_n % new_n == 0 || new_n % old_n == 0,
+                "Error! The smaller pack size must divide the larger one.\n");
+
+  // The last dimension is contiguous (at least at runtime for LayoutStride),
+  // unless the view is LayoutLeft with rank>1.
+  static constexpr bool contiguous_last_dim =
+    rank==1 || !std::is_same<layout_t,Kokkos::LayoutLeft>::value;
+};
+
+// A view of NewValueT aliasing the data of the input view.
+template <typename ViewT, typename NewValueT>
+using ReinterpretedView =
+  Unmanaged<Kokkos::View<typename DataND<NewValueT,ViewT::Rank>::type,
+                         typename ViewT::traits::array_layout,
+                         typename ViewT::traits::device_type,
+                         typename ViewT::traits::memory_traits>>;
+
+// A view of NewValueT that either aliases the data of the input view, or
+// holds a copy of it (see reinterpret_or_copy below).
+template <typename ViewT, typename NewValueT>
+using ReinterpretedOrCopiedView =
+  Kokkos::View<typename DataND<NewValueT,ViewT::Rank>::type,
+               Kokkos::LayoutStride,
+               typename ViewT::traits::device_type>;
+
+template <typename NewValueT, typename ViewT>
+KOKKOS_FORCEINLINE_FUNCTION
+ReinterpretedView<ViewT,NewValueT>
+reinterpret (const ViewT& v) {
+  using check_t = CheckReinterpret<ViewT,NewValueT>;
+  constexpr int rank = check_t::rank;
+  constexpr int old_n = check_t::old_n;
+  constexpr int new_n = check_t::new_n;
+  static_assert(check_t::contiguous_last_dim,
+                "Error! The packed (last) dimension of a LayoutLeft view is not contiguous.\n"
+                "       Use scalarize_or_copy/repack_or_copy instead.\n");
+
+  // The layout comes from user input, so always check it. This function can
+  // also be called inside kernels (e.g., repack in LinInterp), including on
+  // host backends, so we can't throw here. Use scalarize_or_copy/repack_or_copy
+  // to handle views whose layout is not known in advance.
+  auto layout = v.layout();
+  EKAT_KERNEL_REQUIRE_MSG((is_reinterpretable<old_n,new_n>(layout,rank)),
+      "Error! Last dimension not contiguous, or not divisible by the new pack size.\n");
+  rescale_packed_dim<old_n,new_n>(layout,rank);
+  return ReinterpretedView<ViewT,NewValueT>(reinterpret_cast<NewValueT*>(v.data()),layout);
 }
 
-// 2d
-template <typename T, typename ...Parms, int pack_size> KOKKOS_FORCEINLINE_FUNCTION
-Unmanaged<Kokkos::View<T**, Parms...> >
-scalarize (const Kokkos::View<Pack<T, pack_size>**, Parms...>& vp) {
-  return Unmanaged<Kokkos::View<T**, Parms...> >(
-    reinterpret_cast<T*>(vp.data()), vp.extent_int(0), pack_size * vp.extent_int(1));
+// Copy the data of v into a new LayoutRight view of NewValueT.
+template <typename NewValueT, typename ViewT>
+ReinterpretedOrCopiedView<ViewT,NewValueT>
+copy_as (const ViewT& v) {
+  using check_t  = CheckReinterpret<ViewT,NewValueT>;
+  using scalar_t = typename std::remove_const<typename PackTraits<NewValueT>::scalar>::type;
+  using value_t  = typename std::remove_const<NewValueT>::type;
+  using exe_space_t = typename ViewT::traits::execution_space;
+  using policy_t = Kokkos::RangePolicy<exe_space_t>;
+  constexpr int rank = check_t::rank;
+  constexpr int old_n = check_t::old_n;
+  constexpr int new_n = check_t::new_n;
+
+  const size_t nscalars = v.extent(rank-1)*old_n;
+  EKAT_REQUIRE_MSG (nscalars % new_n == 0,
+      "Error! The packed dimension is not divisible by the new pack size.\n"
+      "  - view label: " << v.label() << "\n"
+      "  - last extent: " << v.extent(rank-1) << "\n"
+      "  - old/new pack size: " << old_n << "/" << new_n << "\n");
+
+  Kokkos::LayoutRight layout;
+  size_t ext[8], src_strides[8], dst_strides[8];
+  size_t nouter = 1;
+  for (int d = 0; d < rank; ++d) {
+    ext[d] = layout.dimension[d] = v.extent(d);
+    nouter *= d<rank-1 ? ext[d] : 1;
+  }
+  layout.dimension[rank-1] = nscalars / new_n;
+
+  Kokkos::View<typename DataND<value_t,rank>::type,Kokkos::LayoutRight,typename ViewT::traits::device_type>
+    copy(Kokkos::ViewAllocateWithoutInitializing("ekat::copy_as"),layout);
+  v.stride(src_strides);
+  copy.stride(dst_strides);
+
+  // Loop over scalars, mapping the scalar index along the last dimension
+  // to (pack,slot) in both views.
+  const auto src = v.data();
+  const auto dst = copy.data();
+  Kokkos::parallel_for("ekat::copy_as", policy_t(0,nouter*nscalars),
+                       KOKKOS_LAMBDA (const size_t idx) {
+    const size_t q = idx % nscalars;
+    size_t rem = idx / nscalars;
+    size_t src_offset = (q / old_n)*src_strides[rank-1];
+    size_t dst_offset = (q / new_n)*dst_strides[rank-1];
+    for (int d = rank-2; d >= 0; --d) {
+      const size_t i = rem % ext[d];
+      rem /= ext[d];
+      src_offset += i*src_strides[d];
+      dst_offset += i*dst_strides[d];
+    }
+    reinterpret_cast<scalar_t*>(dst + dst_offset)[q % new_n] =
+      reinterpret_cast<const scalar_t*>(src + src_offset)[q % old_n];
+  });
+
+  return copy;
 }
 
-// 2d const
-template <typename T, typename ...Parms, int pack_size> KOKKOS_FORCEINLINE_FUNCTION
-Unmanaged<Kokkos::View<const T**, Parms...> >
-scalarize (const Kokkos::View<const Pack<T, pack_size>**, Parms...>& vp) {
-  return Unmanaged<Kokkos::View<const T**, Parms...> >(
-    reinterpret_cast<const T*>(vp.data()), vp.extent_int(0), pack_size * vp.extent_int(1));
+template <typename NewValueT, typename ViewT>
+ReinterpretedOrCopiedView<ViewT,NewValueT>
+reinterpret_or_copy (const ViewT& v, std::true_type /* contiguous_last_dim */) {
+  using check_t = CheckReinterpret<ViewT,NewValueT>;
+  if (is_reinterpretable<check_t::old_n,check_t::new_n>(v.layout(),check_t::rank)) {
+    return reinterpret<NewValueT>(v);
+  }
+  return copy_as<NewValueT>(v);
 }
 
-// 1d
-template <typename T, typename ...Parms, int pack_size> KOKKOS_FORCEINLINE_FUNCTION
-Unmanaged<Kokkos::View<T*, Parms...> >
-scalarize (const Kokkos::View<Pack<T, pack_size>*, Parms...>& vp) {
-  return Unmanaged<Kokkos::View<T*, Parms...> >(
-    reinterpret_cast<T*>(vp.data()), pack_size * vp.extent_int(0));
+template <typename NewValueT, typename ViewT>
+ReinterpretedOrCopiedView<ViewT,NewValueT>
+reinterpret_or_copy (const ViewT& v, std::false_type /* contiguous_last_dim */) {
+  return copy_as<NewValueT>(v);
 }
 
-// 1d const
-template <typename T, typename ...Parms, int pack_size> KOKKOS_FORCEINLINE_FUNCTION
-Unmanaged<Kokkos::View<const T*, Parms...> >
-scalarize (const Kokkos::View<const Pack<T, pack_size>*, Parms...>& vp) {
-  return Unmanaged<Kokkos::View<const T*, Parms...> >(
-    reinterpret_cast<const T*>(vp.data()), pack_size * vp.extent_int(0));
+// Reinterpret the data of v as NewValueT if possible, otherwise copy it.
+template <typename NewValueT, typename ViewT>
+ReinterpretedOrCopiedView<ViewT,NewValueT>
+reinterpret_or_copy (const ViewT& v) {
+  using check_t = CheckReinterpret<ViewT,NewValueT>;
+  using tag_t = std::integral_constant<bool,check_t::contiguous_last_dim>;
+  return reinterpret_or_copy<NewValueT>(v,tag_t());
 }
 
-// Turn a View of Pack<T,N>s into a View of Pack<T,M>s.
-// Requirement: the smaller number must divide the larger one:
-//     max(M,N) % min(M,N) == 0.
+} // namespace impl
+
+// Turn a View of Packs into a View of scalars, of the same rank (up to 7),
+// with no copy. The packed dimension is the last one, which must be
+// contiguous: the view can be LayoutRight, or LayoutStride with unit stride
+// along the last dimension. Since this can be called inside kernels, an
+// invalid layout aborts, rather than throwing.
+// Example: const auto b = scalarize(a);
+template <typename DT, typename... Props>
+KOKKOS_FORCEINLINE_FUNCTION
+impl::ReinterpretedView<Kokkos::View<DT,Props...>,
+  typename impl::PackTraits<typename Kokkos::View<DT,Props...>::traits::value_type>::scalar>
+scalarize (const Kokkos::View<DT,Props...>& vp) {
+  using value_t = typename Kokkos::View<DT,Props...>::traits::value_type;
+  return impl::reinterpret<typename impl::PackTraits<value_t>::scalar>(vp);
+}
+
+// Turn a View of Pack<T,N>s into a View of Pack<T,M>s, of the same rank
+// (up to 7), with no copy. Same requirements as scalarize, plus
+//     max(M,N) % min(M,N) == 0,
+// and, if M>N, the last extent (and the strides, for LayoutStride) must be
+// divisible by M/N.
 // Example: const auto b = repack<4>(a);
 
 // Helper struct
@@ -174,146 +329,142 @@ struct RepackType <N,const Pack<T,M>>{
   using type = const Pack<T,N>;
 };
 
-// 2d shrinking
-template <typename NewPackT, typename OldPackT, typename... ViewProps>
+template <int N, typename DT, typename... Props>
 KOKKOS_FORCEINLINE_FUNCTION
-typename std::enable_if<NewPackT::packtag && OldPackT::packtag &&
-    std::is_same<typename NewPackT::scalar,typename OldPackT::scalar>::value &&
-    (OldPackT::n > NewPackT::n),
-    Unmanaged<Kokkos::View<NewPackT**,ViewProps...>>
->::type
-repack_impl (const Kokkos::View<OldPackT**, ViewProps...>& vp) {
-  constexpr auto new_pack_size = NewPackT::n;
-  constexpr auto old_pack_size = OldPackT::n;
-  static_assert(new_pack_size > 0 &&
-                old_pack_size % new_pack_size == 0,
-                "New pack size must divide old pack size.");
-  return Unmanaged<Kokkos::View<NewPackT**, ViewProps...> >(
-    reinterpret_cast<NewPackT*>(vp.data()),
-    vp.extent_int(0),
-    (old_pack_size / new_pack_size) * vp.extent_int(1));
-}
-
-// 2d growing
-template <typename NewPackT, typename OldPackT, typename... ViewProps>
-KOKKOS_FORCEINLINE_FUNCTION
-typename std::enable_if<NewPackT::packtag && OldPackT::packtag &&
-    std::is_same<typename NewPackT::scalar,typename OldPackT::scalar>::value &&
-    (OldPackT::n < NewPackT::n),
-    Unmanaged<Kokkos::View<NewPackT**,ViewProps...>>
->::type
-repack_impl (const Kokkos::View<OldPackT**, ViewProps...>& vp) {
-  constexpr auto new_pack_size = NewPackT::n;
-  constexpr auto old_pack_size = OldPackT::n;
-  static_assert(old_pack_size > 0 &&
-                new_pack_size % old_pack_size == 0,
-                "Old pack size must divide new pack size.");
-  return Unmanaged<Kokkos::View<NewPackT**, ViewProps...> >(
-    reinterpret_cast<NewPackT*>(vp.data()),
-    vp.extent_int(0),
-    (new_pack_size / old_pack_size) * vp.extent_int(1));
-}
-
-// 2d staying the same
-template <typename NewPackT, typename OldPackT, typename... ViewProps>
-KOKKOS_FORCEINLINE_FUNCTION
-typename std::enable_if<NewPackT::packtag && OldPackT::packtag &&
-    std::is_same<typename NewPackT::scalar,typename OldPackT::scalar>::value &&
-    (OldPackT::n == NewPackT::n),
-    Unmanaged<Kokkos::View<NewPackT**,ViewProps...>>
->::type
-repack_impl (const Kokkos::View<OldPackT**, ViewProps...>& vp) {
-  return vp;
+impl::ReinterpretedView<Kokkos::View<DT,Props...>,
+  typename RepackType<N,typename Kokkos::View<DT,Props...>::traits::value_type>::type>
+repack (const Kokkos::View<DT,Props...>& vp) {
+  using value_t = typename Kokkos::View<DT,Props...>::traits::value_type;
+  return impl::reinterpret<typename RepackType<N,value_t>::type>(vp);
 }
 
-// General access point for repack (calls one of the three above)
-template <int N, typename OldPackT, typename... ViewProps>
-KOKKOS_FORCEINLINE_FUNCTION
-Unmanaged<Kokkos::View<typename RepackType<N,OldPackT>::type**,ViewProps...>>
-repack (const Kokkos::View<OldPackT**, ViewProps...>& vp) {
-  return repack_impl<typename RepackType<N,OldPackT>::type>(vp);
+// Same as scalarize/repack, but views whose last dimension is not contiguous
+// (e.g., LayoutLeft, or a strided subview) are copied into a new LayoutRight
+// view, rather than reinterpreted. These must be called outside of kernels,
+// since the copy is a parallel_for on the view's execution space.
+template <typename DT, typename... Props>
+impl::ReinterpretedOrCopiedView<Kokkos::View<DT,Props...>,
+  typename impl::PackTraits<typename Kokkos::View<DT,Props...>::traits::value_type>::scalar>
+scalarize_or_copy (const Kokkos::View<DT,Props...>& vp) {
+  using value_t = typename Kokkos::View<DT,Props...>::traits::value_type;
+  return impl::reinterpret_or_copy<typename impl::PackTraits<value_t>::scalar>(vp);
 }
 
-// 1d shrinking
-template <typename NewPackT, typename OldPackT, typename... ViewProps>
-KOKKOS_FORCEINLINE_FUNCTION
-typename std::enable_if<NewPackT::packtag && OldPackT::packtag &&
-    std::is_same<typename NewPackT::scalar,typename OldPackT::scalar>::value &&
-    (OldPackT::n > NewPackT::n),
-    Unmanaged<Kokkos::View<NewPackT*,ViewProps...>>
->::type
-repack_impl (const Kokkos::View<OldPackT*, ViewProps...>& vp) {
-  constexpr auto new_pack_size = NewPackT::n;
-  constexpr auto old_pack_size = OldPackT::n;
-  static_assert(new_pack_size > 0 &&
-                old_pack_size % new_pack_size == 0,
-                "New pack size must divide old pack size.");
-  return Unmanaged<Kokkos::View<NewPackT*, ViewProps...> >(
-    reinterpret_cast<NewPackT*>(vp.data()),
-    (old_pack_size / new_pack_size) * vp.extent_int(0));
-}
-
-// 1d growing
-template <typename NewPackT, typename OldPackT, typename... ViewProps>
-KOKKOS_FORCEINLINE_FUNCTION
-typename std::enable_if<NewPackT::packtag && OldPackT::packtag &&
-    std::is_same<typename NewPackT::scalar,typename OldPackT::scalar>::value &&
-    (OldPackT::n < NewPackT::n),
-    Unmanaged<Kokkos::View<NewPackT*,ViewProps...>>
->::type
-repack_impl (const Kokkos::View<OldPackT*, ViewProps...>& vp) {
-  constexpr auto new_pack_size = NewPackT::n;
-  constexpr auto old_pack_size = OldPackT::n;
-  static_assert(new_pack_size > 0 &&
-                new_pack_size % old_pack_size == 0,
-                "Old pack size must divide new pack size.");
-  EKAT_KERNEL_ASSERT(vp.extent_int(0) % (new_pack_size / old_pack_size) == 0);
-  return Unmanaged<Kokkos::View<NewPackT*, ViewProps...> >(
-    reinterpret_cast<NewPackT*>(vp.data()),
-    vp.extent_int(0) / (new_pack_size / old_pack_size));
-}
-
-// 1d staying the same
-template <typename NewPackT, typename OldPackT, typename... ViewProps>
-KOKKOS_FORCEINLINE_FUNCTION
-typename std::enable_if<NewPackT::packtag && OldPackT::packtag &&
-    std::is_same<typename NewPackT::scalar,typename OldPackT::scalar>::value &&
-    (OldPackT::n == NewPackT::n),
-    Unmanaged<Kokkos::View<NewPackT*,ViewProps...>>
->::type
-repack_impl (const Kokkos::View<OldPackT*, ViewProps...>& vp) {
-  return vp;
-}
-
-// General access point for repack (calls one of the three above)
-template <int N, typename OldPackT, typename... ViewProps>
-KOKKOS_FORCEINLINE_FUNCTION
-Unmanaged<Kokkos::View<typename RepackType<N,OldPackT>::type*,ViewProps...>>
-repack (const Kokkos::View<OldPackT*, ViewProps...>& vp) {
-  return repack_impl<typename RepackType<N,OldPackT>::type>(vp);
+template <int N, typename DT, typename... Props>
+impl::ReinterpretedOrCopiedView<Kokkos::View<DT,Props...>,
+  typename RepackType<N,typename Kokkos::View<DT,Props...>::traits::value_type>::type>
+repack_or_copy (const Kokkos::View<DT,Props...>& vp) {
+  using value_t = typename Kokkos::View<DT,Props...>::traits::value_type;
+  return impl::reinterpret_or_copy<typename RepackType<N,value_t>::type>(vp);
 }
 
 //
 // Take an array of Host scalar pointers and turn them into device pack views
 //
 
-template <typename T>
-struct HTDVectorT
-{ using type = T; };
+namespace impl {
+
+// Copy a 3d array of scalars with extents (n1,n2,n3) and strides (s1,s2,s3)
+// into a LayoutRight array of packs with extents (n1,n2,npack), setting the
+// padding slots at the end of each row to invalid. Lower rank arrays can be
+// handled by setting the leading extents to 1.
+// If the scalar array is not contiguous along the last dimension (e.g., it
+// comes from Fortran), the copy is tiled along the first and last dimensions,
+// so that the transposition is fused with the packing, without thrashing the
+// cache, and without a temporary. Rows (or tiles) are distributed across the
+// threads of the default host execution space.
+template <typename PackT, typename ScalarT>
+void pack_host_data (PackT* dst, const ScalarT* src,
+                     const size_t n1, const size_t n2, const size_t n3, const size_t npack,
+                     const size_t s1, const size_t s2, const size_t s3)
+{
+  using scalar_t = typename PackT::scalar;
+  constexpr size_t tile = impl::transpose_tile_size;
+
+  EKAT_ASSERT(n3 <= PackT::n*npack);
+  const size_t len = PackT::n*npack;
+  const bool tiled = s3 != 1;
+  const size_t ti = tiled ? tile : 1;
+  const size_t nt1 = (n1 + ti - 1) / ti;
+  scalar_t* const d = reinterpret_cast<scalar_t*>(dst);
+
+  using policy_t = Kokkos::RangePolicy<Kokkos::DefaultHostExecutionSpace>;
+  Kokkos::parallel_for("ekat::pack_host_data", policy_t(0, nt1*n2), [=] (const size_t t) {
+    const size_t k = t % n2;
+    const size_t ibeg = (t / n2)*ti;
+    const size_t iend = impl::min(ibeg + ti, n1);
+    if (tiled) {
+      for (size_t jbeg = 0; jbeg < n3; jbeg += tile) {
+        const size_t jend = impl::min(jbeg + tile, n3);
+        for (size_t i = ibeg; i < iend; ++i) {
+          scalar_t* const row = d + (i*n2 + k)*len;
+          const ScalarT* const srow = src + i*s1 + k*s2;
+          for (size_t j = jbeg; j < jend; ++j) {
+            row[j] = srow[j*s3];
+          }
+        }
+      }
+    } else {
+      for (size_t i = ibeg; i < iend; ++i) {
+        scalar_t* const row = d + (i*n2 + k)*len;
+        const ScalarT* const srow = src + i*s1 + k*s2;
+        vector_simd for (size_t j = 0; j < n3; ++j) {
+          row[j] = srow[j];
+        }
+      }
+    }
+    for (size_t i = ibeg; i < iend; ++i) {
+      scalar_t* const row = d + (i*n2 + k)*len;
+      for (size_t j = n3; j < len; ++j) {
+        row[j] = ScalarTraits<scalar_t>::invalid();
+      }
+    }
+  });
+}
 
-template<>
-struct HTDVectorT<bool>
+// The inverse of pack_host_data: padding slots are discarded.
+template <typename PackT, typename ScalarT>
+void unpack_host_data (ScalarT* dst, const PackT* src,
+                       const size_t n1, const size_t n2, const size_t n3, const size_t npack,
+                       const size_t s1, const size_t s2, const size_t s3)
 {
-  static_assert(
-    sizeof(bool) == sizeof(char),
-    "host_to_device/device_to_host use vectors as flexible memory buffers "
-    "and they make use of vector API calls that are not available in the "
-    "vector<bool> specialization, so if a user is sending bool data, we must "
-    "use vector<char> instead and reinterpret the data as bool*. This is only "
-    "valid if chars and bools are the same size");
+  using scalar_t = typename PackT::scalar;
+  constexpr size_t tile = impl::transpose_tile_size;
+
+  EKAT_ASSERT(n3 <= PackT::n*npack);
+  const size_t len = PackT::n*npack;
+  const bool tiled = s3 != 1;
+  const size_t ti = tiled ? tile : 1;
+  const size_t nt1 = (n1 + ti - 1) / ti;
+  const scalar_t* const d = reinterpret_cast<const scalar_t*>(src);
+
+  using policy_t = Kokkos::RangePolicy<Kokkos::DefaultHostExecutionSpace>;
+  Kokkos::parallel_for("ekat::unpack_host_data", policy_t(0, nt1*n2), [=] (const size_t t) {
+    const size_t k = t % n2;
+    const size_t ibeg = (t / n2)*ti;
+    const size_t iend = impl::min(ibeg + ti, n1);
+    if (tiled) {
+      for (size_t jbeg = 0; jbeg < n3; jbeg += tile) {
+        const size_t jend = impl::min(jbeg + tile, n3);
+        for (size_t j = jbeg; j < jend; ++j) {
+          vector_simd for (size_t i = ibeg; i < iend; ++i) {
+            dst[i*s1 + k*s2 + j*s3] = d[(i*n2 + k)*len + j];
+          }
+        }
+      }
+    } else {
+      for (size_t i = ibeg; i < iend; ++i) {
+        const scalar_t* const row = d + (i*n2 + k)*len;
+        ScalarT* const drow = dst + i*s1 + k*s2;
+        vector_simd for (size_t j = 0; j < n3; ++j) {
+          drow[j] = row[j];
+        }
+      }
+    }
+  });
+}
 
-  using type = char;
-};
+} // namespace impl
 
 // 1d
 template <typename SizeT, typename ViewT>
@@ -331,12 +482,7 @@ void host_to_device(const std::vector<typename ViewT::value_type::scalar const*>
     const size_t npack = (size + PackT::n - 1) / PackT::n;
     views[i] = ViewT("", npack);
     auto host_view = Kokkos::create_mirror_view(views[i]);
-    for (size_t k = 0; k < npack; ++k) {
-      const size_t scalar_offset = k*PackT::n;
-      for (size_t s = 0; s < PackT::n && scalar_offset+s < size; ++s) {
-        host_view(k)[s] = data[i][scalar_offset + s];
-      }
-    }
+    impl::pack_host_data(host_view.data(), data[i], 1, 1, size, npack, 0, 0, 1);
     Kokkos::deep_copy(views[i], host_view);
   }
 }
@@ -350,14 +496,11 @@ void host_to_device(const std::vector<typename ViewT::value_type::scalar const*>
                     bool do_transpose=false)
 {
   using PackT = typename ViewT::value_type;
-  using ScalarT = typename PackT::scalar;
-  using VectorT = typename HTDVectorT<ScalarT>::type;
 
   EKAT_ASSERT(data.size() == dim1_sizes.size());
   EKAT_ASSERT(data.size() == dim2_sizes.size());
   EKAT_ASSERT(data.size() == views.size());
 
-  std::vector<VectorT> tdata;
   for (size_t n = 0; n < data.size(); ++n) {
     const size_t dim1_size = static_cast<size_t>(dim1_sizes[n]);
     const size_t dim2_size = static_cast<size_t>(dim2_sizes[n]);
@@ -365,24 +508,11 @@ void host_to_device(const std::vector<typename ViewT::value_type::scalar const*>
     views[n] = ViewT("", dim1_size, npack);
     auto host_view = Kokkos::create_mirror_view(views[n]);
 
-    ScalarT* the_data = nullptr;
+    // If data comes from fortran, the transposition is fused with the packing
     if (do_transpose) {
-      tdata.reserve(dim1_size * dim2_size);
-      the_data = reinterpret_cast<ScalarT*>(tdata.data());
-      transpose<TransposeDirection::f2c>(data[n], the_data, dim1_size, dim2_size);
-    }
-    else {
-      the_data = const_cast<ScalarT*>(data[n]);
-    }
-
-    for (size_t i = 0; i < dim1_size; ++i) {
-      for (size_t k = 0; k < npack; ++k) {
-        const size_t num_scalars_this_col = k*PackT::n;
-        const size_t scalar_offset = i*dim2_size + num_scalars_this_col;
-        for (size_t s = 0; s < PackT::n && num_scalars_this_col+s < dim2_size; ++s) {
-          host_view(i, k)[s] = the_data[scalar_offset + s];
-        }
-      }
+      impl::pack_host_data(host_view.data(), data[n], dim1_size, 1, dim2_size, npack, 1, 0, dim1_size);
+    } else {
+      impl::pack_host_data(host_view.data(), data[n], dim1_size, 1, dim2_size, npack, dim2_size, 0, 1);
     }
     Kokkos::deep_copy(views[n], host_view);
   }
@@ -398,15 +528,12 @@ void host_to_device(const std::vector<typename ViewT::value_type::scalar const*>
                     bool do_transpose=false)
 {
   using PackT = typename ViewT::value_type;
-  using ScalarT = typename PackT::scalar;
-  using VectorT = typename HTDVectorT<ScalarT>::type;
 
   EKAT_ASSERT(data.size() == dim1_sizes.size());
   EKAT_ASSERT(data.size() == dim2_sizes.size());
   EKAT_ASSERT(data.size() == dim3_sizes.size());
   EKAT_ASSERT(data.size() == views.size());
 
-  std::vector<VectorT> tdata;
   for (size_t n = 0; n < data.size(); ++n) {
     const size_t dim1_size = static_cast<size_t>(dim1_sizes[n]);
     const size_t dim2_size = static_cast<size_t>(dim2_sizes[n]);
@@ -415,26 +542,13 @@ void host_to_device(const std::vector<typename ViewT::value_type::scalar const*>
     views[n] = ViewT("", dim1_size, dim2_size, npack);
     auto host_view = Kokkos::create_mirror_view(views[n]);
 
-    ScalarT* the_data = nullptr;
+    // If data comes from fortran, the transposition is fused with the packing
     if (do_transpose) {
-      tdata.reserve(dim1_size * dim2_size * dim3_size);
-      the_data = reinterpret_cast<ScalarT*>(tdata.data());
-      transpose<TransposeDirection::f2c>(data[n], the_data, dim1_size, dim2_size, dim3_size);
-    }
-    else {
-      the_data = const_cast<ScalarT*>(data[n]);
-    }
-
-    for (size_t i = 0; i < dim1_size; ++i) {
-      for (size_t k = 0; k < dim2_size; ++k) {
-        for (size_t p = 0; p < npack; ++p) {
-          const size_t num_scalars_this_col = p*PackT::n;
-          const size_t scalar_offset = i*(dim2_size*dim3_size) + k*dim3_size + num_scalars_this_col;
-          for (size_t s = 0; s < PackT::n && num_scalars_this_col+s < dim3_size; ++s) {
-            host_view(i, k, p)[s] = the_data[scalar_offset + s];
-          }
-        }
-      }
+      impl::pack_host_data(host_view.data(), data[n], dim1_size, dim2_size, dim3_size, npack,
+                           1, dim1_size, dim1_size*dim2_size);
+    } else {
+      impl::pack_host_data(host_view.data(), data[n], dim1_size, dim2_size, dim3_size, npack,
+                           dim2_size*dim3_size, dim3_size, 1);
     }
     Kokkos::deep_copy(views[n], host_view);
   }
@@ -489,14 +603,10 @@ void device_to_host(const std::vector<typename ViewT::value_type::scalar*>& data
 
   for (size_t i = 0; i < data.size(); ++i) {
     const size_t size = static_cast<size_t>(sizes[i]);
+    const size_t npack = views[i].extent(0);
     const auto host_view = Kokkos::create_mirror_view(views[i]);
     Kokkos::deep_copy(host_view, views[i]);
-    for (size_t k = 0; k < views[i].extent(0); ++k) {
-      const size_t scalar_offset = k*PackT::n;
-      for (size_t s = 0; s < PackT::n && scalar_offset+s < size; ++s) {
-        data[i][scalar_offset + s] = host_view(k)[s];
-      }
-    }
+    impl::unpack_host_data(data[i], host_view.data(), 1, 1, size, npack, 0, 0, 1);
   }
 }
 
@@ -509,14 +619,11 @@ void device_to_host(const std::vector<typename ViewT::value_type::scalar*>& data
                     bool do_transpose=false)
 {
   using PackT = typename ViewT::value_type;
-  using ScalarT = typename PackT::scalar;
-  using VectorT = typename HTDVectorT<ScalarT>::type;
 
   EKAT_ASSERT(data.size() == dim1_sizes.size());
   EKAT_ASSERT(data.size() == dim2_sizes.size());
   EKAT_ASSERT(data.size() == views.size());
 
-  std::vector<VectorT> tdata;
   for (size_t n = 0; n < data.size(); ++n) {
     const size_t dim1_size = static_cast<size_t>(dim1_sizes[n]);
     const size_t dim2_size = static_cast<size_t>(dim2_sizes[n]);
@@ -524,27 +631,11 @@ void device_to_host(const std::vector<typename ViewT::value_type::scalar*>& data
     const auto host_view = Kokkos::create_mirror_view(views[n]);
     Kokkos::deep_copy(host_view, views[n]);
 
-    ScalarT* the_data = nullptr;
+    // If data goes to fortran, the transposition is fused with the unpacking
     if (do_transpose) {
-      tdata.reserve(dim1_size * dim2_size);
-      the_data = reinterpret_cast<ScalarT*>(tdata.data());
-    }
-    else {
-      the_data = data[n];
-    }
-
-    for (size_t i = 0; i < dim1_size; ++i) {
-      for (size_t k = 0; k < npack; ++k) {
-        const size_t num_scalars_this_col = k*PackT::n;
-        const size_t scalar_offset = i*dim2_size + num_scalars_this_col;
-        for (size_t s = 0; s < PackT::n && num_scalars_this_col+s < dim2_size; ++s) {
-          the_data[scalar_offset + s] = host_view(i, k)[s];
-        }
-      }
-    }
-
-    if (do_transpose) {
-      transpose<TransposeDirection::c2f>(the_data, data[n], dim1_size, dim2_size);
+      impl::unpack_host_data(data[n], host_view.data(), dim1_size, 1, dim2_size, npack, 1, 0, dim1_size);
+    } else {
+      impl::unpack_host_data(data[n], host_view.data(), dim1_size, 1, dim2_size, npack, dim2_size, 0, 1);
     }
   }
 }
@@ -559,15 +650,12 @@ void device_to_host(const std::vector<typename ViewT::value_type::scalar*>& data
                     bool do_transpose=false)
 {
   using PackT = typename ViewT::value_type;
-  using ScalarT = typename PackT::scalar;
-  using VectorT = typename HTDVectorT<ScalarT>::type;
 
   EKAT_ASSERT(data.size() == dim1_sizes.size());
   EKAT_ASSERT(data.size() == dim2_sizes.size());
   EKAT_ASSERT(data.size() == dim3_sizes.size());
   EKAT_ASSERT(data.size() == views.size());
 
-  std::vector<VectorT> tdata;
   for (size_t n = 0; n < data.size(); ++n) {
     const size_t dim1_size = static_cast<size_t>(dim1_sizes[n]);
     const size_t dim2_size = static_cast<size_t>(dim2_sizes[n]);
@@ -576,29 +664,13 @@ void device_to_host(const std::vector<typename ViewT::value_type::scalar*>& data
     const auto host_view = Kokkos::create_mirror_view(views[n]);
     Kokkos::deep_copy(host_view, views[n]);
 
-    ScalarT* the_data = nullptr;
+    // If data goes to fortran, the transposition is fused with the unpacking
     if (do_transpose) {
-      tdata.reserve(dim1_size * dim2_size * dim3_size);
-      the_data = reinterpret_cast<ScalarT*>(tdata.data());
-    }
-    else {
-      the_data = data[n];
-    }
-
-    for (size_t i = 0; i < dim1_size; ++i) {
-      for (size_t k = 0; k < dim2_size; ++k) {
-        for (size_t p = 0; p < npack; ++p) {
-          const size_t num_scalars_this_col = p*PackT::n;
-          const size_t scalar_offset = i*(dim2_size*dim3_size) + k*dim3_size + num_scalars_this_col;
-          for (size_t s = 0; s < PackT::n && num_scalars_this_col+s < dim3_size; ++s) {
-            the_data[scalar_offset + s] = host_view(i, k, p)[s];
-          }
-        }
-      }
-    }
-
-    if (do_transpose) {
-      transpose<TransposeDirection::c2f>(the_data, data[n], dim1_size, dim2_size, dim3_size);
+      impl::unpack_host_data(data[n], host_view.data(), dim1_size, dim2_size, dim3_size, npack,
+                             1, dim1_size, dim1_size*dim2_size);
+    } else {
+      impl::unpack_host_data(data[n], host_view.data(), dim1_size, dim2_size, dim3_size, npack,
+                             dim2_size*dim3_size, dim3_size, 1);
     }
   }
 }
@@ -635,6 +707,614 @@ void device_to_host(const std::vector<typename ViewT::value_type::scalar*>& data
   device_to_host(data, dim1_sizes, dim2_sizes, dim3_sizes, views, do_transpose);
 }
 
+//
+// Batched host<->device transfers
+//
+// The overloads below take an extra HostDeviceStaging argument. Instead of
+// allocating one device view and one mirror per array, all arrays are packed
+// into a single host staging buffer, moved with a single deep_copy, and the
+// output views are unmanaged views aliasing slices of a single device
+// allocation, owned by the staging object.
+// Both buffers are only ever grown, so that a staging object reused across
+// calls does not allocate once it reached its high-water mark. As a
+// consequence, the views returned by host_to_device are only valid as long
+// as the staging object is alive, and until it is used for another
+// host_to_device call.
+//
+
+namespace impl {
+
+// The host memory space used for the staging buffer. If pinned memory
+// is requested, and the device is a GPU, use the page-locked host space,
+// to get faster (and async-capable) transfers.
+template <typename MemSpace, bool UsePinned>
+struct HostStagingSpace {
+  using type = Kokkos::HostSpace;
+};
+
+#if defined KOKKOS_ENABLE_CUDA
+template <>
+struct HostStagingSpace<Kokkos::CudaSpace,true> {
+  using type = Kokkos::CudaHostPinnedSpace;
+};
+#elif defined KOKKOS_ENABLE_HIP
+template <>
+struct HostStagingSpace<Kokkos::Experimental::HIPSpace,true> {
+  using type = Kokkos::Experimental::HIPHostPinnedSpace;
+};
+#endif
+
+// If the device buffer is already in the staging space, there's no need for
+// a separate host buffer (similar to what create_mirror_view does)
+template <typename HostViewT, typename DevViewT>
+typename std::enable_if<std::is_same<typename HostViewT::memory_space,
+                                     typename DevViewT::memory_space>::value>::type
+alloc_host_staging (HostViewT& host, const DevViewT& dev) {
+  host = dev;
+}
+
+template <typename HostViewT, typename DevViewT>
+typename std::enable_if<not std::is_same<typename HostViewT::memory_space,
+                                         typename DevViewT::memory_space>::value>::type
+alloc_host_staging (HostViewT& host, const DevViewT& dev) {
+  host = HostViewT(Kokkos::view_alloc(Kokkos::WithoutInitializing, "HostDeviceStaging::host"),
+                   dev.extent(0));
+}
+
+} // namespace impl
+
+template <typename PackT, typename DeviceT = DefaultDevice, bool UsePinned = false>
+class HostDeviceStaging
+{
+public:
+  using pack_type      = PackT;
+  using device_type    = DeviceT;
+  using host_mem_space = typename impl::HostStagingSpace<typename DeviceT::memory_space,UsePinned>::type;
+
+  using device_view_t  = Kokkos::View<PackT*, Kokkos::LayoutRight, DeviceT>;
+  using host_view_t    = Kokkos::View<PackT*, Kokkos::LayoutRight, host_mem_space>;
+
+  // Ensure both buffers can hold npacks packs. Content is NOT preserved
+  // if a reallocation is needed.
+  void reserve (const size_t npacks) {
+    if (npacks > m_dev.extent(0)) {
+      m_dev = device_view_t(Kokkos::view_alloc(Kokkos::WithoutInitializing, "HostDeviceStaging::device"),
+                            npacks);
+      impl::alloc_host_staging(m_host, m_dev);
+    }
+  }
+
+  size_t capacity () const { return m_dev.extent(0); }
+
+  const device_view_t& device_buffer () const { return m_dev; }
+  const host_view_t&   host_buffer   () const { return m_host; }
+
+  // Offset (in packs) of the data of a view aliasing the device buffer
+  template <typename ViewT>
+  size_t offset_of (const ViewT& v) const {
+    const auto offset = reinterpret_cast<const PackT*>(v.data()) - m_dev.data();
+    EKAT_REQUIRE_MSG (offset>=0 && static_cast<size_t>(offset+v.size())<=capacity(),
+        "Error! Input view does not alias the device buffer of this HostDeviceStaging object.\n");
+    return offset;
+  }
+
+  // Move the packs in [begin,end) of the staging buffer to/from device.
+  // The copy is enqueued on the given execution space instance, so it is
+  // asynchronous w.r.t. the host (if the backend supports it).
+  template <typename ExecSpace>
+  void host_to_device (const ExecSpace& exec, const size_t begin, const size_t end) const {
+    const auto range = std::make_pair(begin,end);
+    Kokkos::deep_copy(exec, Kokkos::subview(m_dev,range), Kokkos::subview(m_host,range));
+  }
+  template <typename ExecSpace>
+  void device_to_host (const ExecSpace& exec, const size_t begin, const size_t end) const {
+    const auto range = std::make_pair(begin,end);
+    Kokkos::deep_copy(exec, Kokkos::subview(m_host,range), Kokkos::subview(m_dev,range));
+  }
+
+private:
+  device_view_t m_dev;
+  host_view_t   m_host;
+};
+
+// A handle to an asynchronous transfer. The transfer is guaranteed to be
+// complete (and the host/device data safe to use) only after wait() is called.
+// Note: kernels enqueued on the same execution space instance used for the
+//       transfer are ordered after it, so they don't need to wait for it.
+// The destructor waits for the transfer, if still pending.
+template <typename ExecSpace>
+class TransferHandle
+{
+public:
+  TransferHandle () = default;
+
+  explicit TransferHandle (const ExecSpace& exec,
+                           std::function<void()> finalize = std::function<void()>())
+   : m_exec (exec)
+   , m_finalize (std::move(finalize))
+   , m_pending (true)
+  {}
+
+  TransferHandle (const TransferHandle&) = delete;
+  TransferHandle& operator= (const TransferHandle&) = delete;
+
+  TransferHandle (TransferHandle&& src)
+   : m_exec (src.m_exec)
+   , m_finalize (std::move(src.m_finalize))
+   , m_pending (src.m_pending)
+  {
+    src.m_pending = false;
+  }
+
+  TransferHandle& operator= (TransferHandle&& src) {
+    if (this!=&src) {
+      wait();
+      m_exec = src.m_exec;
+      m_finalize = std::move(src.m_finalize);
+      m_pending = src.m_pending;
+      src.m_pending = false;
+    }
+    return *this;
+  }
+
+  ~TransferHandle () { wait(); }
+
+  bool pending () const { return m_pending; }
+
+  void wait () {
+    if (m_pending) {
+      m_pending = false;
+      if (m_finalize) {
+        m_finalize();
+      } else {
+        m_exec.fence();
+      }
+    }
+  }
+
+private:
+  ExecSpace             m_exec;
+  std::function<void()> m_finalize;
+  bool                  m_pending = false;
+};
+
+namespace impl {
+
+// Layout of a host array (up to rank 3) and of its packed copy in the
+// staging buffer, as expected by pack_host_data/unpack_host_data.
+struct StagedArray {
+  size_t offset;        // Offset (in packs) in the staging buffer
+  size_t n1, n2, n3;    // Extents of the host array
+  size_t npack;         // Packs per row in the staging buffer
+  size_t s1, s2, s3;    // Strides of the host array
+
+  // Number of packs per slice along the first dimension
+  size_t slice_size () const { return n2*npack; }
+  size_t size () const { return n1*n2*npack; }
+};
+
+inline StagedArray
+make_staged_array (const size_t offset, const size_t n1, const size_t n2, const size_t n3,
+                   const size_t pack_size, const bool fortran_order)
+{
+  StagedArray a;
+  a.offset = offset;
+  a.n1 = n1;
+  a.n2 = n2;
+  a.n3 = n3;
+  a.npack = (n3 + pack_size - 1) / pack_size;
+  if (fortran_order) {
+    a.s1 = 1;
+    a.s2 = n1;
+    a.s3 = n1*n2;
+  } else {
+    a.s1 = n2*n3;
+    a.s2 = n3;
+    a.s3 = 1;
+  }
+  return a;
+}
+
+// A range of the staging buffer that is moved with a single copy, together
+// with the slabs [ibeg,iend) (along the first dimension) of the arrays it holds.
+struct StagingChunk {
+  size_t begin, end;
+  std::vector<std::array<size_t,3>> slabs; // (array, ibeg, iend)
+};
+
+// If chunk_size is 0, the whole data is moved with a single copy. Otherwise,
+// each array is split in chunks of chunk_size slices along the first dimension
+// (e.g., column blocks), so that packing one chunk on host can
+// overlap with the copy of the next one.
+inline std::vector<StagingChunk>
+make_staging_chunks (const std::vector<StagedArray>& arrays, const size_t chunk_size)
+{
+  std::vector<StagingChunk> chunks;
+  if (chunk_size==0) {
+    StagingChunk c;
+    c.begin = arrays.size()>0 ? arrays[0].offset : 0;
+    c.end = c.begin;
+    for (size_t n = 0; n < arrays.size(); ++n) {
+      c.begin = std::min(c.begin, arrays[n].offset);
+      c.end = std::max(c.end, arrays[n].offset + arrays[n].size());
+      c.slabs.push_back({n, 0, arrays[n].n1});
+    }
+    chunks.push_back(c);
+  } else {
+    for (size_t n = 0; n < arrays.size(); ++n) {
+      const auto& a = arrays[n];
+      for (size_t ibeg = 0; ibeg < a.n1; ibeg += chunk_size) {
+        const size_t iend = std::min(ibeg + chunk_size, a.n1);
+        StagingChunk c;
+        c.begin = a.offset + ibeg*a.slice_size();
+        c.end = a.offset + iend*a.slice_size();
+        c.slabs.push_back({n, ibeg, iend});
+        chunks.push_back(c);
+      }
+    }
+  }
+  return chunks;
+}
+
+// Pack all chunks in the host staging buffer, enqueueing the copy of each
+// chunk to device as soon as it is ready.
+template <typename ScalarT, typename StagingT, typename ExecSpace>
+void stage_host_to_device (const ExecSpace& exec,
+                           const std::vector<const ScalarT*>& data,
+                           const std::vector<StagedArray>& arrays,
+                           const StagingT& staging,
+                           const size_t chunk_size)
+{
+  const auto host_buf = staging.host_buffer().data();
+  for (const auto& c : make_staging_chunks(arrays, chunk_size)) {
+    for (const auto& slab : c.slabs) {
+      const auto& a = arrays[slab[0]];
+      const size_t ibeg = slab[1];
+      const size_t iend = slab[2];
+      pack_host_data(host_buf + a.offset + ibeg*a.slice_size(), data[slab[0]] + ibeg*a.s1,
+                     iend - ibeg, a.n2, a.n3, a.npack, a.s1, a.s2, a.s3);
+    }
+    staging.host_to_device(exec, c.begin, c.end);
+  }
+}
+
+// Enqueue the copies of all chunks to host, and return a handle whose wait()
+// method completes the transfer, unpacking the chunks on host. The copies
+// proceed while the caller does other work, until wait() is called.
+template <typename ScalarT, typename StagingT, typename ExecSpace>
+TransferHandle<ExecSpace>
+unstage_device_to_host (const ExecSpace& exec,
+                        const std::vector<ScalarT*>& data,
+                        const std::vector<StagedArray>& arrays,
+                        const StagingT& staging,
+                        const size_t chunk_size)
+{
+  const auto chunks = make_staging_chunks(arrays, chunk_size);
+  for (const auto& c : chunks) {
+    staging.device_to_host(exec, c.begin, c.end);
+  }
+
+  // Note: capture staging by value, so that the buffers stay alive
+  auto finalize = [=] () {
+    const auto host_buf = staging.host_buffer().data();
+    exec.fence();
+    for (const auto& c : chunks) {
+      for (const auto& slab : c.slabs) {
+        const auto& a = arrays[slab[0]];
+        const size_t ibeg = slab[1];
+        const size_t iend = slab[2];
+        unpack_host_data(data[slab[0]] + ibeg*a.s1, host_buf + a.offset + ibeg*a.slice_size(),
+                         iend - ibeg, a.n2, a.n3, a.npack, a.s1, a.s2, a.s3);
+      }
+    }
+  };
+  return TransferHandle<ExecSpace>(exec, finalize);
+}
+
+} // namespace impl
+
+//
+// Asynchronous batched transfers
+//
+// Same as the batched transfers above, but the copies are enqueued on the
+// input execution space instance, and a TransferHandle is returned.
+// For host_to_device_async, the output views can be used right away in
+// kernels enqueued on the same instance; the host data can be modified
+// only after waiting on the handle.
+// For device_to_host_async, the host data is available only after waiting
+// on the handle, and the input host pointers must stay valid until then.
+// For device_to_host_async, all copies are enqueued before returning, so
+// they overlap with whatever the host does before waiting, and wait() only
+// unpacks the data.
+// If chunk_size>0, arrays are split in chunks of chunk_size slices along the
+// first dimension (one chunk per array in the 1d case), so that host packing
+// of one chunk overlaps the copy to device of another.
+//
+
+// 1d
+template <typename ExecSpace, typename SizeT, typename ViewT, typename DeviceT, bool UsePinned>
+TransferHandle<ExecSpace>
+host_to_device_async(const ExecSpace& exec,
+                     const std::vector<typename ViewT::value_type::scalar const*>& data,
+                     const std::vector<SizeT>& sizes,
+                     std::vector<ViewT>& views,
+                     HostDeviceStaging<typename ViewT::value_type,DeviceT,UsePinned>& staging,
+                     const size_t chunk_size = 0)
+{
+  using PackT = typename ViewT::value_type;
+
+  static_assert(std::is_same<typename ViewT::memory_space,typename DeviceT::memory_space>::value,
+                "Error! Views and staging buffer must be in the same memory space.\n");
+
+  EKAT_ASSERT(data.size() == sizes.size());
+  EKAT_ASSERT(data.size() == views.size());
+
+  std::vector<impl::StagedArray> arrays(data.size());
+  size_t offset = 0;
+  for (size_t i = 0; i < data.size(); ++i) {
+    arrays[i] = impl::make_staged_array(offset, 1, 1, sizes[i], PackT::n, false);
+    offset += arrays[i].size();
+  }
+  staging.reserve(offset);
+
+  impl::stage_host_to_device(exec, data, arrays, staging, chunk_size);
+
+  for (size_t i = 0; i < data.size(); ++i) {
+    views[i] = ViewT(staging.device_buffer().data() + arrays[i].offset, arrays[i].npack);
+  }
+  return TransferHandle<ExecSpace>(exec);
+}
+
+// 2d - set do_transpose to true if host data is coming from fortran
+template <typename ExecSpace, typename SizeT, typename ViewT, typename DeviceT, bool UsePinned>
+TransferHandle<ExecSpace>
+host_to_device_async(const ExecSpace& exec,
+                     const std::vector<typename ViewT::value_type::scalar const*>& data,
+                     const std::vector<SizeT>& dim1_sizes,
+                     const std::vector<SizeT>& dim2_sizes,
+                     std::vector<ViewT>& views,
+                     HostDeviceStaging<typename ViewT::value_type,DeviceT,UsePinned>& staging,
+                     bool do_transpose=false,
+                     const size_t chunk_size = 0)
+{
+  using PackT = typename ViewT::value_type;
+
+  static_assert(std::is_same<typename ViewT::memory_space,typename DeviceT::memory_space>::value,
+                "Error! Views and staging buffer must be in the same memory space.\n");
+
+  EKAT_ASSERT(data.size() == dim1_sizes.size());
+  EKAT_ASSERT(data.size() == dim2_sizes.size());
+  EKAT_ASSERT(data.size() == views.size());
+
+  std::vector<impl::StagedArray> arrays(data.size());
+  size_t offset = 0;
+  for (size_t n = 0; n < data.size(); ++n) {
+    arrays[n] = impl::make_staged_array(offset, dim1_sizes[n], 1, dim2_sizes[n], PackT::n, do_transpose);
+    offset += arrays[n].size();
+  }
+  staging.reserve(offset);
+
+  impl::stage_host_to_device(exec, data, arrays, staging, chunk_size);
+
+  for (size_t n = 0; n < data.size(); ++n) {
+    const auto& a = arrays[n];
+    views[n] = ViewT(staging.device_buffer().data() + a.offset, a.n1, a.npack);
+  }
+  return TransferHandle<ExecSpace>(exec);
+}
+
+// 3d - set do_transpose to true if host data is coming from fortran
+template <typename ExecSpace, typename SizeT, typename ViewT, typename DeviceT, bool UsePinned>
+TransferHandle<ExecSpace>
+host_to_device_async(const ExecSpace& exec,
+                     const std::vector<typename ViewT::value_type::scalar const*>& data,
+                     const std::vector<SizeT>& dim1_sizes,
+                     const std::vector<SizeT>& dim2_sizes,
+                     const std::vector<SizeT>& dim3_sizes,
+                     std::vector<ViewT>& views,
+                     HostDeviceStaging<typename ViewT::value_type,DeviceT,UsePinned>& staging,
+                     bool do_transpose=false,
+                     const size_t chunk_size = 0)
+{
+  using PackT = typename ViewT::value_type;
+
+  static_assert(std::is_same<typename ViewT::memory_space,typename DeviceT::memory_space>::value,
+                "Error! Views and staging buffer must be in the same memory space.\n");
+
+  EKAT_ASSERT(data.size() == dim1_sizes.size());
+  EKAT_ASSERT(data.size() == dim2_sizes.size());
+  EKAT_ASSERT(data.size() == dim3_sizes.size());
+  EKAT_ASSERT(data.size() == views.size());
+
+  std::vector<impl::StagedArray> arrays(data.size());
+  size_t offset = 0;
+  for (size_t n = 0; n < data.size(); ++n) {
+    arrays[n] = impl::make_staged_array(offset, dim1_sizes[n], dim2_sizes[n], dim3_sizes[n],
+                                        PackT::n, do_transpose);
+    offset += arrays[n].size();
+  }
+  staging.reserve(offset);
+
+  impl::stage_host_to_device(exec, data, arrays, staging, chunk_size);
+
+  for (size_t n = 0; n < data.size(); ++n) {
+    const auto& a = arrays[n];
+    views[n] = ViewT(staging.device_buffer().data() + a.offset, a.n1, a.n2, a.npack);
+  }
+  return TransferHandle<ExecSpace>(exec);
+}
+
+// 1d
+// Note: views must have been obtained from a batched host_to_device call
+//       with the same staging object.
+template <typename ExecSpace, typename SizeT, typename ViewT, typename DeviceT, bool UsePinned>
+TransferHandle<ExecSpace>
+device_to_host_async(const ExecSpace& exec,
+                     const std::vector<typename ViewT::value_type::scalar*>& data,
+                     const std::vector<SizeT>& sizes,
+                     const std::vector<ViewT>& views,
+                     HostDeviceStaging<typename ViewT::value_type,DeviceT,UsePinned>& staging,
+                     const size_t chunk_size = 0)
+{
+  using PackT = typename ViewT::value_type;
+
+  EKAT_ASSERT(data.size() == sizes.size());
+  EKAT_ASSERT(data.size() == views.size());
+
+  std::vector<impl::StagedArray> arrays(data.size());
+  for (size_t i = 0; i < data.size(); ++i) {
+    arrays[i] = impl::make_staged_array(staging.offset_of(views[i]), 1, 1, sizes[i], PackT::n, false);
+    arrays[i].npack = views[i].extent(0);
+  }
+
+  return impl::unstage_device_to_host(exec, data, arrays, staging, chunk_size);
+}
+
+// 2d - set do_transpose to true if host data is going to fortran
+template <typename ExecSpace, typename SizeT, typename ViewT, typename DeviceT, bool UsePinned>
+TransferHandle<ExecSpace>
+device_to_host_async(const ExecSpace& exec,
+                     const std::vector<typename ViewT::value_type::scalar*>& data,
+                     const std::vector<SizeT>& dim1_sizes,
+                     const std::vector<SizeT>& dim2_sizes,
+                     const std::vector<ViewT>& views,
+                     HostDeviceStaging<typename ViewT::value_type,DeviceT,UsePinned>& staging,
+                     bool do_transpose=false,
+                     const size_t chunk_size = 0)
+{
+  using PackT = typename ViewT::value_type;
+
+  EKAT_ASSERT(data.size() == dim1_sizes.size());
+  EKAT_ASSERT(data.size() == dim2_sizes.size());
+  EKAT_ASSERT(data.size() == views.size());
+
+  std::vector<impl::StagedArray> arrays(data.size());
+  for (size_t n = 0; n < data.size(); ++n) {
+    arrays[n] = impl::make_staged_array(staging.offset_of(views[n]), dim1_sizes[n], 1, dim2_sizes[n],
+                                        PackT::n, do_transpose);
+    arrays[n].npack = views[n].extent(1);
+  }
+
+  return impl::unstage_device_to_host(exec, data, arrays, staging, chunk_size);
+}
+
+// 3d - set do_transpose to true if host data is going to fortran
+template <typename ExecSpace, typename SizeT, typename ViewT, typename DeviceT, bool UsePinned>
+TransferHandle<ExecSpace>
+device_to_host_async(const ExecSpace& exec,
+                     const std::vector<typename ViewT::value_type::scalar*>& data,
+                     const std::vector<SizeT>& dim1_sizes,
+                     const std::vector<SizeT>& dim2_sizes,
+                     const std::vector<SizeT>& dim3_sizes,
+                     const std::vector<ViewT>& views,
+                     HostDeviceStaging<typename ViewT::value_type,DeviceT,UsePinned>& staging,
+                     bool do_transpose=false,
+                     const size_t chunk_size = 0)
+{
+  using PackT = typename ViewT::value_type;
+
+  EKAT_ASSERT(data.size() == dim1_sizes.size());
+  EKAT_ASSERT(data.size() == dim2_sizes.size());
+  EKAT_ASSERT(data.size() == dim3_sizes.size());
+  EKAT_ASSERT(data.size() == views.size());
+
+  std::vector<impl::StagedArray> arrays(data.size());
+  for (size_t n = 0; n < data.size(); ++n) {
+    arrays[n] = impl::make_staged_array(staging.offset_of(views[n]), dim1_sizes[n], dim2_sizes[n],
+                                        dim3_sizes[n], PackT::n, do_transpose);
+    arrays[n].npack = views[n].extent(2);
+  }
+
+  return impl::unstage_device_to_host(exec, data, arrays, staging, chunk_size);
+}
+
+//
+// Synchronous batched transfers: same as the async ones, with a single
+// copy, enqueued on the default instance of the staging device, followed
+// by a wait.
+//
+
+// 1d
+template <typename SizeT, typename ViewT, typename DeviceT, bool UsePinned>
+void host_to_device(const std::vector<typename ViewT::value_type::scalar const*>& data,
+                    const std::vector<SizeT>& sizes,
+                    std::vector<ViewT>& views,
+                    HostDeviceStaging<typename ViewT::value_type,DeviceT,UsePinned>& staging)
+{
+  using ExeSpace = typename DeviceT::execution_space;
+  host_to_device_async(ExeSpace(), data, sizes, views, staging).wait();
+}
+
+// 2d - set do_transpose to true if host data is coming from fortran
+template <typename SizeT, typename ViewT, typename DeviceT, bool UsePinned>
+void host_to_device(const std::vector<typename ViewT::value_type::scalar const*>& data,
+                    const std::vector<SizeT>& dim1_sizes,
+                    const std::vector<SizeT>& dim2_sizes,
+                    std::vector<ViewT>& views,
+                    HostDeviceStaging<typename ViewT::value_type,DeviceT,UsePinned>& staging,
+                    bool do_transpose=false)
+{
+  using ExeSpace = typename DeviceT::execution_space;
+  host_to_device_async(ExeSpace(), data, dim1_sizes, dim2_sizes, views, staging, do_transpose).wait();
+}
+
+// 3d - set do_transpose to true if host data is coming from fortran
+template <typename SizeT, typename ViewT, typename DeviceT, bool UsePinned>
+void host_to_device(const std::vector<typename ViewT::value_type::scalar const*>& data,
+                    const std::vector<SizeT>& dim1_sizes,
+                    const std::vector<SizeT>& dim2_sizes,
+                    const std::vector<SizeT>& dim3_sizes,
+                    std::vector<ViewT>& views,
+                    HostDeviceStaging<typename ViewT::value_type,DeviceT,UsePinned>& staging,
+                    bool do_transpose=false)
+{
+  using ExeSpace = typename DeviceT::execution_space;
+  host_to_device_async(ExeSpace(), data, dim1_sizes, dim2_sizes, dim3_sizes,
+                       views, staging, do_transpose).wait();
+}
+
+// 1d
+// Note: views must have been obtained from a batched host_to_device call
+//       with the same staging object. Only one device-to-host copy is
+//       performed, spanning all the views.
+template <typename SizeT, typename ViewT, typename DeviceT, bool UsePinned>
+void device_to_host(const std::vector<typename ViewT::value_type::scalar*>& data,
+                    const std::vector<SizeT>& sizes,
+                    std::vector<ViewT>& views,
+                    HostDeviceStaging<typename ViewT::value_type,DeviceT,UsePinned>& staging)
+{
+  using ExeSpace = typename DeviceT::execution_space;
+  device_to_host_async(ExeSpace(), data, sizes, views, staging).wait();
+}
+
+// 2d - set do_transpose to true if host data is going to fortran
+template <typename SizeT, typename ViewT, typename DeviceT, bool UsePinned>
+void device_to_host(const std::vector<typename ViewT::value_type::scalar*>& data,
+                    const std::vector<SizeT>& dim1_sizes,
+                    const std::vector<SizeT>& dim2_sizes,
+                    std::vector<ViewT>& views,
+                    HostDeviceStaging<typename ViewT::value_type,DeviceT,UsePinned>& staging,
+                    bool do_transpose=false)
+{
+  using ExeSpace = typename DeviceT::execution_space;
+  device_to_host_async(ExeSpace(), data, dim1_sizes, dim2_sizes, views, staging, do_transpose).wait();
+}
+
+// 3d - set do_transpose to true if host data is going to fortran
+template <typename SizeT, typename ViewT, typename DeviceT, bool UsePinned>
+void device_to_host(const std::vector<typename ViewT::value_type::scalar*>& data,
+                    const std::vector<SizeT>& dim1_sizes,
+                    const std::vector<SizeT>& dim2_sizes,
+                    const std::vector<SizeT>& dim3_sizes,
+                    std::vector<ViewT>& views,
+                    HostDeviceStaging<typename ViewT::value_type,DeviceT,UsePinned>& staging,
+                    bool do_transpose=false)
+{
+  using ExeSpace = typename DeviceT::execution_space;
+  device_to_host_async(ExeSpace(), data, dim1_sizes, dim2_sizes, dim3_sizes,
+                       views, staging, do_transpose).wait();
+}
+
 } // namespace ekat
 
 #endif // EKAT_PACK_KOKKOS_HPP
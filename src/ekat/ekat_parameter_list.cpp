@@ -4,12 +4,71 @@
 
 namespace ekat {
 
-ParameterList& ParameterList::sublist (const std::string& name) {
-  if (m_sublists.find(name)==m_sublists.end()) {
-    ParameterList p(name);
-    m_sublists[name] = p;
+ParameterList::KeyPath::KeyPath (const std::vector<std::string>& names)
+{
+  EKAT_REQUIRE_MSG (names.size()>0, "Error! Cannot create an empty KeyPath.\n");
+  m_keys.reserve(names.size());
+  for (const auto& n : names) {
+    m_keys.emplace_back(n);
   }
-  return m_sublists[name];
+}
+
+ParameterList& ParameterList::sublist (const Key& key) {
+  auto ins = m_sublists.try_emplace(key.id(),key.name());
+  if (ins.second) {
+    m_names_index.add(key.name());
+  }
+  return *ins.first;
+}
+
+const ParameterList& ParameterList::sublist (const Key& key) const {
+  return check_found(m_sublists.find(key.id()),key.name());
+}
+
+const ParameterList& ParameterList::sublist (const std::string& name) const {
+  return check_found(m_sublists.find(name),name);
+}
+
+ParameterList& ParameterList::sublist (const KeyPath& path) {
+  ParameterList* pl = this;
+  for (const auto& k : path.keys()) {
+    pl = &pl->sublist(k);
+  }
+  return *pl;
+}
+
+const ParameterList& ParameterList::sublist (const KeyPath& path) const {
+  const ParameterList* pl = this;
+  for (const auto& k : path.keys()) {
+    pl = &pl->sublist(k);
+  }
+  return *pl;
+}
+
+const ParameterList& ParameterList::parent (const KeyPath& path) const {
+  const auto& keys = path.keys();
+  const ParameterList* pl = this;
+  for (size_t i=0; i+1<keys.size(); ++i) {
+    pl = &pl->sublist(keys[i]);
+  }
+  return *pl;
+}
+
+bool ParameterList::isParameter (const KeyPath& path) const {
+  const auto& keys = path.keys();
+  const ParameterList* pl = this;
+  for (size_t i=0; i+1<keys.size(); ++i) {
+    pl = pl->m_sublists.find(keys[i].id());
+    if (pl==nullptr) {
+      return false;
+    }
+  }
+  return pl->isParameter(keys.back());
+}
+
+std::string ParameterList::did_you_mean (const std::string& name) const {
+  const auto s = m_names_index.did_you_mean(name);
+  return s.empty() ? s : "  " + s + "\n";
 }
 
 void ParameterList::print(std::ostream& out, const int indent, const int indent_inc) const {
@@ -17,20 +76,22 @@ void ParameterList::print(std::ostream& out, const int indent, const int indent_
 
   out << tab << name() << ":\n";
   tab.append(indent_inc,' ');
-  for (auto it : m_params) {
-    out << std::showpoint << tab << it.first << ": " << it.second << "\n";
-  }
-  for (auto it : m_sublists) {
-    it.second.print(out,indent+indent_inc,indent_inc);
-  }
+  m_params.for_each_sorted([&](const std::string& pname, const any& p) {
+    out << std::showpoint << tab << pname << ": " << p << "\n";
+  });
+  m_sublists.for_each_sorted([&](const std::string&, const ParameterList& sl) {
+    sl.print(out,indent+indent_inc,indent_inc);
+  });
 }
 
 void ParameterList::import (const ParameterList& src) {
   for (const auto& it : src.m_sublists) {
     m_sublists[it.first] = it.second;
+    m_names_index.add(StringInterner::str(it.first));
   }
   for (const auto& it : src.m_params) {
     m_params[it.first] = it.second;
+    m_names_index.add(StringInterner::str(it.first));
   }
 }
 
@@ -2,10 +2,12 @@
 #define EKAT_PARAMETER_LIST_HPP
 
 #include "ekat/std_meta/ekat_std_any.hpp"
-#include "ekat/std_meta/ekat_std_map_key_iterator.hpp"
+#include "ekat/util/ekat_interned_map.hpp"
+#include "ekat/util/ekat_suggestion_index.hpp"
 #include "ekat_assert.hpp"
 
-#include <map>
+#include <initializer_list>
+#include <vector>
 
 namespace ekat {
 
@@ -13,7 +15,10 @@ namespace ekat {
  * A class to store list of arbitrary parameters (possibly recursively)
  *
  * A parameter list store two things: parameters, and sublists.
- * Each of these is stored in a map, which uses a string as key.
+ * Each of these is stored in a hash map, keyed by interned strings
+ * (see InternedMap). Names can be pre-resolved into a Key (or a KeyPath,
+ * for nested sublists), which can be reused for cheaper lookups.
+ * Iteration over names (and hence printing) is in lexicographic order.
  *
  * Parameters are stored using ekat::any, which allows to store pretty
  * much anything you want in the list. However, this means that when
@@ -31,6 +36,36 @@ namespace ekat {
 class ParameterList {
 public:
 
+  // A pre-resolved parameter/sublist name. The interned name is stored too,
+  // since interned strings live until the end of the program, so that
+  // accessors using a Key never go back to the StringInterner.
+  class Key {
+  public:
+    explicit Key (const std::string& name)
+     : m_id(StringInterner::intern(name))
+     , m_name(&StringInterner::str(m_id))
+    {}
+
+    int id () const { return m_id; }
+    const std::string& name () const { return *m_name; }
+  private:
+    int                 m_id;
+    const std::string*  m_name;
+  };
+
+  // A pre-resolved path to a parameter (or sublist): all names but the last
+  // one are sublist names. E.g., KeyPath{"a","b","c"} refers to the entry "c"
+  // in pl.sublist("a").sublist("b").
+  class KeyPath {
+  public:
+    KeyPath (std::initializer_list<std::string> names) : KeyPath(std::vector<std::string>(names)) {}
+    explicit KeyPath (const std::vector<std::string>& names);
+
+    const std::vector<Key>& keys () const { return m_keys; }
+  private:
+    std::vector<Key> m_keys;
+  };
+
   // Constructor(s) & Destructor
   ParameterList () = default;
   explicit ParameterList (const std::string& name) : m_name(name) {}
@@ -57,14 +92,33 @@ public:
   template<typename T>
   void set (const std::string& name, const T& value);
 
-  // Sublist getters
-  ParameterList& sublist (const std::string& name);
+  // Getters using pre-resolved names/paths
+  template<typename T>
+  T& get (const Key& key);
+  template<typename T>
+  const T& get (const Key& key) const;
+  template<typename T>
+  T& get (const KeyPath& path);
+  template<typename T>
+  const T& get (const KeyPath& path) const;
+
+  // Sublist getters. The non-const versions create the sublist if not found.
+  ParameterList& sublist (const std::string& name) { return sublist(Key(name)); }
+  const ParameterList& sublist (const std::string& name) const;
 
-  const ParameterList& sublist (const std::string& name) const { return m_sublists.at(name); }
+  ParameterList& sublist (const Key& key);
+  const ParameterList& sublist (const Key& key) const;
+
+  // Sublist at given path (all keys are interpreted as sublist names)
+  ParameterList& sublist (const KeyPath& path);
+  const ParameterList& sublist (const KeyPath& path) const;
 
   // Check methods, to verify a parameter/sublist is present
-  bool isParameter (const std::string& name) const { return m_params.find(name)!=m_params.end(); }
-  bool isSublist   (const std::string& name) const { return m_sublists.find(name)!=m_sublists.end(); }
+  bool isParameter (const std::string& name) const { return m_params.find(name)!=nullptr; }
+  bool isSublist   (const std::string& name) const { return m_sublists.find(name)!=nullptr; }
+  bool isParameter (const Key& key) const { return m_params.find(key.id())!=nullptr; }
+  bool isSublist   (const Key& key) const { return m_sublists.find(key.id())!=nullptr; }
+  bool isParameter (const KeyPath& path) const;
 
   // Check methods, to determine the type of a node
   template<typename T>
@@ -79,81 +133,140 @@ public:
   // Add content of src into *this. Existing items will be overwritten.
   void import (const ParameterList& src);
 
-  // Access const iterators to stored data
-  using params_names_const_iter   = map_key_const_iterator<std::map<std::string,any>>;
-  using sublists_names_const_iter = map_key_const_iterator<std::map<std::string,ParameterList>>;
+  // Access const iterators to stored data (names are in lexicographic order)
+  using params_names_const_iter   = InternedMap<any>::key_const_iterator;
+  using sublists_names_const_iter = InternedMap<ParameterList>::key_const_iterator;
 
-  params_names_const_iter   params_names_cbegin ()   const { return params_names_const_iter(m_params.cbegin()); }
-  params_names_const_iter   params_names_cend   ()   const { return params_names_const_iter(m_params.cend());   }
+  params_names_const_iter   params_names_cbegin ()   const { return m_params.keys_cbegin(); }
+  params_names_const_iter   params_names_cend   ()   const { return m_params.keys_cend();   }
 
-  sublists_names_const_iter sublists_names_cbegin () const { return sublists_names_const_iter(m_sublists.cbegin()); }
-  sublists_names_const_iter sublists_names_cend   () const { return sublists_names_const_iter(m_sublists.cend());   }
+  sublists_names_const_iter sublists_names_cbegin () const { return m_sublists.keys_cbegin(); }
+  sublists_names_const_iter sublists_names_cend   () const { return m_sublists.keys_cend();   }
 
 private:
 
-  std::string                           m_name;
-  std::map<std::string,any>             m_params;
-  std::map<std::string,ParameterList>   m_sublists;
+  // Throws if the key is not found. The error message (including suggestions
+  // for misspelled names) is only assembled if the check fails.
+  template<typename T>
+  T& check_found (T* p, const std::string& name) const;
+
+  // Suggestions for a name not found in this list (empty if none)
+  std::string did_you_mean (const std::string& name) const;
+
+  // The list containing the last entry of the path
+  const ParameterList& parent (const KeyPath& path) const;
+
+  // Throws if the type stored in p is not T. The error message is only
+  // assembled if the check fails.
+  template<typename T>
+  void check_type (const std::string& name, const any& p) const;
+
+  std::string                   m_name;
+  InternedMap<any>              m_params;
+  InternedMap<ParameterList>    m_sublists;
+
+  // Names of all params and sublists, updated on insertion (entries are never
+  // erased), so that failed lookups do not need to rebuild it
+  SuggestionIndex               m_names_index;
 };
 
 // ====================== IMPLEMENTATION ===================== //
 
+// Note: all accessors perform a single map search, and hold a reference
+//       to the stored any, so that no holder is copied.
+
 template<typename T>
-inline T& ParameterList::get (const std::string& name) {
-  // Check entry exists
-  EKAT_REQUIRE_MSG ( isParameter(name),
-      "Error! Key '" + name + "' not found in parameter list '" + m_name + "'.\n");
-  auto p = m_params[name];
+inline void ParameterList::check_type (const std::string& name, const any& p) const {
   EKAT_REQUIRE_MSG ( p.isType<T>(),
       "Error! Attempting to access parameter using the wrong type.\n"
       "   - list name : " + m_name + "\n"
       "   - param name: " + name + "\n"
       "   - param type: " + std::string(p.content().type().name()) + "\n"
       "   - input type: " + std::string(typeid(T).name()) + "'.\n");
+}
+
+template<typename T>
+inline T& ParameterList::check_found (T* p, const std::string& name) const {
+  EKAT_REQUIRE_MSG ( p!=nullptr,
+      "Error! Key '" + name + "' not found in parameter list '" + m_name + "'.\n" +
+      did_you_mean(name));
+  return *p;
+}
+
+template<typename T>
+inline T& ParameterList::get (const std::string& name) {
+  auto& p = check_found(m_params.find(name),name);
+  check_type<T>(name,p);
 
   return any_cast<T>(p);
 }
 
 template<typename T>
 inline const T& ParameterList::get (const std::string& name) const {
-  EKAT_REQUIRE_MSG ( isParameter(name),
-      "Error! Key '" + name + "' not found in parameter list '" + m_name + "'.\n");
+  const auto& p = check_found(m_params.find(name),name);
+  check_type<T>(name,p);
 
-  auto p = m_params.at(name);
-  EKAT_REQUIRE_MSG ( p.isType<T>(),
-      "Error! Attempting to access parameter using the wrong type.\n"
-      "   - list name : " + m_name + "\n"
-      "   - param name: " + name + "\n"
-      "   - param type: " + std::string(p.content().type().name()) + "\n"
-      "   - input type: " + std::string(typeid(T).name()) + ".\n");
+  return any_cast<T>(p);
+}
+
+template<typename T>
+inline T& ParameterList::get (const Key& key) {
+  auto& p = check_found(m_params.find(key.id()),key.name());
+  check_type<T>(key.name(),p);
 
   return any_cast<T>(p);
 }
 
+template<typename T>
+inline const T& ParameterList::get (const Key& key) const {
+  const auto& p = check_found(m_params.find(key.id()),key.name());
+  check_type<T>(key.name(),p);
+
+  return any_cast<T>(p);
+}
+
+template<typename T>
+inline T& ParameterList::get (const KeyPath& path) {
+  // The const version does not modify the list, and *this is not const
+  const auto& self = *this;
+  return const_cast<T&>(self.get<T>(path));
+}
+
+template<typename T>
+inline const T& ParameterList::get (const KeyPath& path) const {
+  return parent(path).get<T>(path.keys().back());
+}
+
 template<typename T>
 inline T& ParameterList::get (const std::string& name, const T& def_value) {
-  if ( !isParameter(name) ) {
-    m_params[name].template reset<T>(def_value);
+  auto ins = m_params.try_emplace(name);
+  auto& p = *ins.first;
+  if ( ins.second ) {
+    m_names_index.add(name);
+    p.template reset<T>(def_value);
   }
-  return get<T>(name);
+  check_type<T>(name,p);
+
+  return any_cast<T>(p);
 }
 
 template<typename T>
 inline void ParameterList::set (const std::string& name, const T& value) {
-  if ( !isParameter(name) ) {
-    m_params[name].template reset<T>(value);
+  auto ins = m_params.try_emplace(name);
+  auto& p = *ins.first;
+  if ( ins.second ) {
+    m_names_index.add(name);
+    p.template reset<T>(value);
   } else {
-    get<T>(name) = value;
+    check_type<T>(name,p);
+    any_cast<T>(p) = value;
   }
 }
 
 template<typename T>
 inline bool ParameterList::isType (const std::string& name) const {
   // Check entry exists
-  EKAT_REQUIRE_MSG ( isParameter(name),
-      "Error! Key '" + name + "' not found in parameter list '" + m_name + "'.\n");
-
-  return m_params.at(name).isType<T>();
+  return check_found(m_params.find(name),name).isType<T>();
 }
 
 } // namespace ekat
@@ -2,7 +2,11 @@
 #include "ekat/ekat_session.hpp"
 #include "ekat/ekat_assert.hpp"
 #include "ekat/util/ekat_arch.hpp"
+#include "ekat/mpi/ekat_comm.hpp"
 
+#include <cstdlib>
+#include <iostream>
+#include <string>
 #include <vector>
 #include <cfenv>
 
@@ -66,6 +70,18 @@ void initialize_kokkos () {
   Kokkos::initialize(settings);
 }
 
+// Whether MPI can still be used (e.g., to reduce comm stats across ranks)
+bool mpi_is_running () {
+#ifdef EKAT_ENABLE_MPI
+  int initialized, finalized;
+  MPI_Initialized(&initialized);
+  MPI_Finalized(&finalized);
+  return initialized!=0 && finalized==0;
+#else
+  return true;
+#endif
+}
+
 } // anonymous namespace
 
 namespace ekat {
@@ -103,11 +119,19 @@ void initialize_ekat_session (int argc, char **argv, bool print_config) {
   enable_fpes(ekat_impl::get_default_fpes());
 #endif
 
+  const char* comm_stats = std::getenv("EKAT_COMM_STATS");
+  if (comm_stats!=nullptr && std::string(comm_stats)!="0") {
+    enable_comm_stats();
+  }
+
   if (print_config) std::cout << ekat_config_string() << "\n";
 }
 
 extern "C" {
 void finalize_ekat_session () {
+  if (comm_stats_enabled() && ekat_impl::mpi_is_running()) {
+    print_comm_stats(Comm(MPI_COMM_WORLD),std::cout);
+  }
   Kokkos::finalize();
 }
 } // extern "C"
@@ -3,6 +3,7 @@
 
 #include "ekat/std_meta/ekat_std_type_traits.hpp" // For "remove_all_pointers"
 
+#include <functional>
 #include <string>
 #include <typeinfo>
 
@@ -83,6 +84,23 @@ struct StreamExists {
   static constexpr bool value = type::value;
 };
 
+// std::hash specialization
+template<typename T>
+struct HashExists {
+  template<typename U>
+  static auto test(U*)
+    -> decltype(
+        std::hash<U>{}(std::declval<const U&>()),
+        std::true_type());
+
+  template<typename>
+  static std::false_type test(...);
+
+  using type = decltype(test<T>(0));
+
+  static constexpr bool value = type::value;
+};
+
 } // namespace ekat
 
 #endif // EKAT_TYPE_TRAITS_HPP
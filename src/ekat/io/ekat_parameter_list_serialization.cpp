@@ -0,0 +1,290 @@
+#include "ekat/io/ekat_parameter_list_serialization.hpp"
+#include "ekat/util/ekat_file_utils.hpp"
+#include "ekat/ekat_assert.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <type_traits>
+
+namespace ekat {
+
+namespace {
+
+// Bump this if the format changes
+constexpr char          magic[4] = {'E','K','P','L'};
+constexpr std::uint32_t format_version = 3;
+
+// Header: magic, format version, content hash
+constexpr size_t header_size = sizeof(magic) + sizeof(std::uint32_t) + sizeof(std::uint64_t);
+
+// The type of a stored parameter
+enum class ParamTag : std::uint8_t {
+  Bool,
+  Int,
+  Double,
+  String,
+  CharVector,
+  IntVector,
+  DoubleVector,
+  StringVector
+};
+
+class BinaryWriter {
+public:
+  explicit BinaryWriter (std::vector<char>& buffer) : m_buffer(buffer) {}
+
+  template<typename T>
+  void write (const T& v) {
+    static_assert (std::is_trivially_copyable<T>::value,
+        "Error! Only trivially copyable types can be written as raw bytes.\n");
+    write_bytes (&v,sizeof(T));
+  }
+
+  void write (const std::string& s) {
+    write_size (s.size());
+    write_bytes (s.data(),s.size());
+  }
+
+  template<typename T>
+  void write (const std::vector<T>& v) {
+    write_size (v.size());
+    write_bytes (v.data(),v.size()*sizeof(T));
+  }
+
+  void write (const std::vector<std::string>& v) {
+    write_size (v.size());
+    for (const auto& s : v) {
+      write (s);
+    }
+  }
+
+  void write_size (const size_t n) {
+    write (static_cast<std::uint64_t>(n));
+  }
+
+  void write_bytes (const void* data, const size_t n) {
+    const char* p = static_cast<const char*>(data);
+    m_buffer.insert(m_buffer.end(),p,p+n);
+  }
+
+private:
+  std::vector<char>& m_buffer;
+};
+
+class BinaryReader {
+public:
+  BinaryReader (const char* data, const size_t size) : m_pos(data), m_end(data+size) {}
+
+  template<typename T>
+  void read (T& v) {
+    static_assert (std::is_trivially_copyable<T>::value,
+        "Error! Only trivially copyable types can be read as raw bytes.\n");
+    read_bytes (&v,sizeof(T));
+  }
+
+  void read (std::string& s) {
+    s.resize(read_size());
+    read_bytes (&s[0],s.size());
+  }
+
+  template<typename T>
+  void read (std::vector<T>& v) {
+    v.resize(read_size());
+    read_bytes (v.data(),v.size()*sizeof(T));
+  }
+
+  void read (std::vector<std::string>& v) {
+    v.resize(read_size());
+    for (auto& s : v) {
+      read (s);
+    }
+  }
+
+  size_t read_size () {
+    std::uint64_t n;
+    read (n);
+    return n;
+  }
+
+  void read_bytes (void* data, const size_t n) {
+    EKAT_REQUIRE_MSG (n<=static_cast<size_t>(m_end-m_pos),
+        "Error! Unexpected end of buffer while deserializing a ParameterList.\n");
+    if (n>0) {
+      std::memcpy(data,m_pos,n);
+    }
+    m_pos += n;
+  }
+
+  bool done () const { return m_pos==m_end; }
+
+private:
+  const char* m_pos;
+  const char* m_end;
+};
+
+// Write the parameter, if it has type T, and return whether it did
+template<typename T>
+bool write_param_if (BinaryWriter& w, const ParameterList& params,
+                     const std::string& name, const ParamTag tag) {
+  if (not params.isType<T>(name)) {
+    return false;
+  }
+  w.write(tag);
+  w.write(params.get<T>(name));
+  return true;
+}
+
+template<typename T>
+void read_param (BinaryReader& r, ParameterList& params, const std::string& name) {
+  T value;
+  r.read(value);
+  params.set<T>(name,value);
+}
+
+// Sublists are stored with both their key in the parent list and their name,
+// since the two may differ (e.g., after a rename, or an assignment).
+void write_list (BinaryWriter& w, const ParameterList& params) {
+  w.write(params.name());
+
+  w.write_size(std::distance(params.params_names_cbegin(),params.params_names_cend()));
+  for (auto it=params.params_names_cbegin(); it!=params.params_names_cend(); ++it) {
+    const auto& name = *it;
+    w.write(name);
+    const bool ok = write_param_if<bool>(w,params,name,ParamTag::Bool) ||
+                    write_param_if<int>(w,params,name,ParamTag::Int) ||
+                    write_param_if<double>(w,params,name,ParamTag::Double) ||
+                    write_param_if<std::string>(w,params,name,ParamTag::String) ||
+                    write_param_if<std::vector<char>>(w,params,name,ParamTag::CharVector) ||
+                    write_param_if<std::vector<int>>(w,params,name,ParamTag::IntVector) ||
+                    write_param_if<std::vector<double>>(w,params,name,ParamTag::DoubleVector) ||
+                    write_param_if<std::vector<std::string>>(w,params,name,ParamTag::StringVector);
+    EKAT_REQUIRE_MSG (ok,
+        "Error! Cannot serialize parameter '" + name + "' in list '" + params.name() + "'.\n"
+        "  Supported types: bool, int, double, std::string, and std::vector of\n"
+        "  char, int, double, and std::string.\n");
+  }
+
+  w.write_size(std::distance(params.sublists_names_cbegin(),params.sublists_names_cend()));
+  for (auto it=params.sublists_names_cbegin(); it!=params.sublists_names_cend(); ++it) {
+    w.write(*it);
+    write_list(w,params.sublist(*it));
+  }
+}
+
+void read_list (BinaryReader& r, ParameterList& params) {
+  std::string name;
+  r.read(name);
+  params.rename(name);
+
+  const size_t nparams = r.read_size();
+  for (size_t i=0; i<nparams; ++i) {
+    r.read(name);
+    ParamTag tag;
+    r.read(tag);
+    switch (tag) {
+      case ParamTag::Bool:         read_param<bool>(r,params,name);                     break;
+      case ParamTag::Int:          read_param<int>(r,params,name);                      break;
+      case ParamTag::Double:       read_param<double>(r,params,name);                   break;
+      case ParamTag::String:       read_param<std::string>(r,params,name);              break;
+      case ParamTag::CharVector:   read_param<std::vector<char>>(r,params,name);        break;
+      case ParamTag::IntVector:    read_param<std::vector<int>>(r,params,name);         break;
+      case ParamTag::DoubleVector: read_param<std::vector<double>>(r,params,name);      break;
+      case ParamTag::StringVector: read_param<std::vector<std::string>>(r,params,name); break;
+      default:
+        EKAT_ERROR_MSG ("Error! Invalid parameter type tag while deserializing a ParameterList.\n"
+                        "  - param name: " + name + "\n"
+                        "  - type tag  : " + std::to_string(static_cast<int>(tag)) + "\n");
+    }
+  }
+
+  const size_t nsublists = r.read_size();
+  for (size_t i=0; i<nsublists; ++i) {
+    r.read(name);
+    read_list(r,params.sublist(name));
+  }
+}
+
+} // anonymous namespace
+
+std::vector<char> serialize_parameter_list (const ParameterList& params) {
+  std::vector<char> buffer;
+  BinaryWriter w(buffer);
+
+  // Write header with a placeholder for the hash, which is computed at the end
+  const std::uint64_t hash = 0;
+  w.write_bytes(magic,sizeof(magic));
+  w.write(format_version);
+  w.write(hash);
+  write_list(w,params);
+
+  const std::uint64_t h = content_hash(buffer.data()+header_size,buffer.size()-header_size);
+  std::memcpy(&buffer[header_size-sizeof(h)],&h,sizeof(h));
+
+  return buffer;
+}
+
+ParameterList deserialize_parameter_list (const char* data, const size_t size) {
+  BinaryReader r(data,size);
+
+  char m[sizeof(magic)];
+  std::uint32_t version;
+  std::uint64_t hash;
+  r.read_bytes(m,sizeof(m));
+  EKAT_REQUIRE_MSG (std::memcmp(m,magic,sizeof(magic))==0,
+      "Error! Input buffer does not contain a serialized ParameterList.\n");
+  r.read(version);
+  EKAT_REQUIRE_MSG (version==format_version,
+      "Error! Unsupported ParameterList serialization format version.\n"
+      "  - buffer version  : " + std::to_string(version) + "\n"
+      "  - expected version: " + std::to_string(format_version) + "\n");
+  r.read(hash);
+  EKAT_REQUIRE_MSG (hash==content_hash(data+header_size,size-header_size),
+      "Error! Hash mismatch while deserializing a ParameterList. The buffer may be corrupted.\n");
+
+  ParameterList params;
+  read_list(r,params);
+  EKAT_REQUIRE_MSG (r.done(),
+      "Error! Trailing bytes found after deserializing a ParameterList.\n");
+
+  return params;
+}
+
+std::uint64_t parameter_list_hash (const ParameterList& params) {
+  const auto buffer = serialize_parameter_list(params);
+  std::uint64_t hash;
+  std::memcpy(&hash,&buffer[header_size-sizeof(hash)],sizeof(hash));
+  return hash;
+}
+
+void write_parameter_list_binary (const std::string& fname, const ParameterList& params) {
+  const auto buffer = serialize_parameter_list(params);
+  FILEPtr fid(fopen(fname.c_str(),"wb"));
+  EKAT_REQUIRE_MSG (fid, "Error! Could not open '" + fname + "' for writing.\n");
+  write(buffer.data(),buffer.size(),fid);
+}
+
+ParameterList read_parameter_list_binary (const std::string& fname) {
+  FILEPtr fid(fopen(fname.c_str(),"rb"));
+  EKAT_REQUIRE_MSG (fid, "Error! Could not open '" + fname + "' for reading.\n");
+
+  std::fseek(fid.get(),0,SEEK_END);
+  const long size = std::ftell(fid.get());
+  std::fseek(fid.get(),0,SEEK_SET);
+  EKAT_REQUIRE_MSG (size>=0, "Error! Could not determine the size of '" + fname + "'.\n");
+
+  std::vector<char> buffer(size);
+  read(buffer.data(),buffer.size(),fid);
+  return deserialize_parameter_list(buffer);
+}
+
+std::uint64_t content_hash (const char* data, const size_t size) {
+  std::uint64_t h = 14695981039346656037ull;
+  for (size_t i=0; i<size; ++i) {
+    h ^= static_cast<unsigned char>(data[i]);
+    h *= 1099511628211ull;
+  }
+  return h;
+}
+
+} // namespace ekat
@@ -0,0 +1,51 @@
+#ifndef EKAT_PARAMETER_LIST_SERIALIZATION_HPP
+#define EKAT_PARAMETER_LIST_SERIALIZATION_HPP
+
+#include "ekat/ekat_parameter_list.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ekat {
+
+/*
+ * Serialize a ParameterList (recursively) into a compact binary buffer,
+ * and rebuild a ParameterList from such a buffer.
+ *
+ * Only the types that the YAML parser can produce are supported: bool, int,
+ * double, std::string, and std::vector of char (i.e., bool), int, double,
+ * and std::string. If any other type is found, an exception is thrown.
+ *
+ * Values are stored with the native byte order and sizes, so the buffer is
+ * meant to be exchanged between processes running on the same architecture
+ * (e.g., to broadcast a parsed input file, or for restart files), not as a
+ * portable file format.
+ *
+ * The buffer header stores a hash of the content, which is checked upon
+ * deserialization. Since parameters and sublists are stored in lexicographic
+ * order, two lists with the same content have the same hash, regardless of
+ * the order in which entries were added.
+ */
+
+std::vector<char> serialize_parameter_list (const ParameterList& params);
+
+ParameterList deserialize_parameter_list (const char* data, const size_t size);
+
+inline ParameterList deserialize_parameter_list (const std::vector<char>& buffer) {
+  return deserialize_parameter_list (buffer.data(), buffer.size());
+}
+
+// The content hash of a list (as stored in the serialized buffer)
+std::uint64_t parameter_list_hash (const ParameterList& params);
+
+// Write/read a serialized list to/from a binary file
+void write_parameter_list_binary (const std::string& fname, const ParameterList& params);
+ParameterList read_parameter_list_binary (const std::string& fname);
+
+// 64-bit FNV-1a hash of a byte sequence
+std::uint64_t content_hash (const char* data, const size_t size);
+
+} // namespace ekat
+
+#endif // EKAT_PARAMETER_LIST_SERIALIZATION_HPP
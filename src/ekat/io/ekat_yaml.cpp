@@ -1,13 +1,29 @@
 #include "ekat/util/ekat_string_utils.hpp"
 #include "ekat/util/ekat_meta_utils.hpp"
 #include "ekat/io/ekat_yaml.hpp"
+#include "ekat/io/ekat_parameter_list_serialization.hpp"
 #include "ekat/ekat_assert.hpp"
 
+#include "ekat/util/ekat_file_utils.hpp"
+
 #include <yaml-cpp/yaml.h>
 
+#include <sys/stat.h>
+#include <unistd.h>
+#include <locale.h>
+#ifdef __APPLE__
+#include <xlocale.h>
+#endif
+
+#include <cctype>
+#include <cerrno>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
 #include <sstream>
 #include <fstream>
 #include <iomanip>
+#include <limits>
 
 namespace ekat {
 
@@ -24,72 +40,115 @@ void parse_node (const YAML::Node& node,
                  const std::string& key,
                  ParameterList& list);
 
-// Check if input string can be interpreted as given type
-template<typename T>
-bool is_type (const std::string& s);
-
-template<>
-bool is_type<bool> (const std::string& s) {
-  return s==CaseInsensitiveString("true") ||
-         s==CaseInsensitiveString("false");
-}
-template<>
-bool is_type<int> (const std::string& s) {
-  std::istringstream is(s);
-  int d;
-  is >> d;
-  return !is.fail() && is.eof();
-}
-template<>
-bool is_type<double> (const std::string& s) {
-  std::istringstream is(s);
-  double d;
-  is >> d;
-  return !is.fail() && is.eof();
+// The most specific type a scalar string can be interpreted as.
+// The order matters: ints are also valid doubles, and anything is a string.
+enum class ScalarKind { Bool, Int, Double, String };
+
+// A scalar string, classified, along with its value. Only the value
+// fields compatible with the kind are valid (e.g., for Int, both i and d).
+struct ScalarValue {
+  ScalarKind kind;
+  bool       b;
+  int        i;
+  double     d;
+};
+
+bool is_true_false (const std::string& s, bool& value) {
+  if (caseInsensitiveEqualString(s,"true")) {
+    value = true;
+    return true;
+  } else if (caseInsensitiveEqualString(s,"false")) {
+    value = false;
+    return true;
+  }
+  return false;
 }
-template<>
-bool is_type<std::string> (const std::string&) {
-  // This is the fallback case. A string...is a string.
-  return true;
+
+// The "C" locale, so that parsing numbers does not depend on the global locale
+// (e.g., with a decimal comma, "1.5" would not be a valid number).
+locale_t c_locale () {
+  static const locale_t loc = newlocale(LC_ALL_MASK,"C",static_cast<locale_t>(0));
+  return loc;
 }
 
-// Convert a string to the given type
-template<typename T>
-T str2type (const std::string& s);
+// Classify the string in a single pass, computing the value at the same time.
+// The accepted formats match those of std::istream's operator>> in the "C"
+// locale (leading whitespace allowed, no trailing characters). In particular,
+// for doubles, hexadecimal values, inf, and nan are not accepted (they remain
+// strings).
+ScalarValue classify_scalar (const std::string& s) {
+  ScalarValue v;
+  v.kind = ScalarKind::String;
+
+  if (is_true_false(s,v.b)) {
+    v.kind = ScalarKind::Bool;
+    return v;
+  }
 
-template<>
-bool str2type<bool> (const std::string& s) {
-  return s==CaseInsensitiveString("true");
-}
-template<>
-char str2type<char> (const std::string& s) {
-  return (s=="true" || s=="TRUE") ? 1 : 0;
+  const char* begin = s.c_str();
+  const char* end   = begin + s.size();
+  char* last;
+
+  errno = 0;
+  const long l = strtol_l(begin,&last,10,c_locale());
+  if (last!=begin && last==end && errno==0 &&
+      l>=std::numeric_limits<int>::min() && l<=std::numeric_limits<int>::max()) {
+    v.kind = ScalarKind::Int;
+    v.i = static_cast<int>(l);
+    v.d = static_cast<double>(l);
+    return v;
+  }
+
+  // strtod also accepts hex floats, inf, and nan, which we reject
+  for (const char* c = begin; c!=end; ++c) {
+    if (std::isalpha(static_cast<unsigned char>(*c)) && *c!='e' && *c!='E') {
+      return v;
+    }
+  }
+  errno = 0;
+  const double d = strtod_l(begin,&last,c_locale());
+  if (last!=begin && last==end &&
+      not (errno==ERANGE && std::abs(d)==HUGE_VAL)) {
+    v.kind = ScalarKind::Double;
+    v.d = d;
+  }
+  return v;
 }
-template<>
-int str2type<int> (const std::string& s) {
-  return std::stoi(s);
+
+// The most specific kind that can represent both a and b
+ScalarKind common_kind (const ScalarKind a, const ScalarKind b) {
+  if (a==b) {
+    return a;
+  }
+  const bool numeric_a = a==ScalarKind::Int || a==ScalarKind::Double;
+  const bool numeric_b = b==ScalarKind::Int || b==ScalarKind::Double;
+  return numeric_a && numeric_b ? ScalarKind::Double : ScalarKind::String;
 }
-template<>
-double str2type<double> (const std::string& s) {
-  return std::stod(s);
+
+// Whether a value of kind 'actual' can be stored as 'requested'
+bool is_compatible (const ScalarKind actual, const ScalarKind requested) {
+  return actual==requested || requested==ScalarKind::String ||
+         (actual==ScalarKind::Int && requested==ScalarKind::Double);
 }
-template<>
-std::string str2type<std::string> (const std::string& s) {
-  return s;
+
+void set_scalar (ParameterList& list, const std::string& key,
+                 const std::string& str, const ScalarValue& v,
+                 const ScalarKind kind) {
+  switch (kind) {
+    case ScalarKind::Bool:   list.set(key,v.b); break;
+    case ScalarKind::Int:    list.set(key,v.i); break;
+    case ScalarKind::Double: list.set(key,v.d); break;
+    case ScalarKind::String: list.set(key,str); break;
+  }
 }
 
-// Returns true if all entries of the node sequence can be
-// interpreted as values of type T
 template<typename T>
-bool is_seq (const YAML::Node& node) {
-  int n = node.size();
-  for (int i=0; i<n; ++i) {
-    std::string str = node[i].as<std::string>();
-    if (not is_type<T>(str)) {
-      return false;
-    }
+std::vector<T> fill_seq (const std::vector<ScalarValue>& vals, T (*get) (const ScalarValue&)) {
+  std::vector<T> vec(vals.size());
+  for (size_t i=0; i<vals.size(); ++i) {
+    vec[i] = get(vals[i]);
   }
-  return true;
+  return vec;
 }
 
 // ---------- IMPLEMENTATION -------------- // 
@@ -103,42 +162,36 @@ void parse_node<YAML::NodeType::Scalar> (
   EKAT_REQUIRE_MSG (node.Type()==YAML::NodeType::Scalar,
                       "Error! Actual node type incompatible with template parameter.\n");
 
-  // Extract scalar as string, then try some casts
-  // First int, then double, and finally fall back to string
-  std::string str = node.as<std::string>();
+  // Extract scalar as string, then classify it (bool, int, double, or string)
+  const std::string& str = node.Scalar();
   const auto& tag = node.Tag();
 
+  if (tag=="!" or tag=="!!str" or tag=="tag:yaml.org,2002:str") {
+    list.set(key,str);
+    return;
+  }
+
+  const auto v = classify_scalar(str);
   if (tag=="?") {
     // There's no tag annotation regarding the node type,
-    // so we just try in order bool, int, double, string
-    TypeListFor<values_t>([&](auto t) -> bool{
-      using vtype = decltype(t);
-      if (is_type<vtype>(str)) {
-        list.set(key,str2type<vtype>(str));
-        return true;
-      }
-      return false;
-    });
+    // so we use the most specific type
+    set_scalar(list,key,str,v,v.kind);
   } else {
     // YAY, the user is telling us how to interpret the values
+    ScalarKind requested;
     if (tag=="!!bool" or tag=="tag:yaml.org,2002:bool") {
-      EKAT_REQUIRE_MSG (is_type<bool>(str),
-          "Error! Tag " + tag + " not compatible with the stored value '" + str + "'\n");
-      list.set(key,str2type<bool>(str));
+      requested = ScalarKind::Bool;
     } else if (tag=="!!int" or tag=="tag:yaml.org,2002:int") {
-      EKAT_REQUIRE_MSG (is_type<int>(str),
-          "Error! Tag " + tag + " not compatible with the stored value '" + str + "'\n");
-      list.set(key,str2type<int>(str));
+      requested = ScalarKind::Int;
     } else if (tag=="!!float" or tag=="tag:yaml.org,2002:float") {
-      EKAT_REQUIRE_MSG (is_type<double>(str),
-          "Error! Tag " + tag + " not compatible with the stored value '" + str + "'\n");
-      list.set(key,str2type<double>(str));
-    } else if (tag=="!" or tag=="!!str" or tag=="tag:yaml.org,2002:str") {
-      list.set(key,str);
+      requested = ScalarKind::Double;
     } else {
       EKAT_ERROR_MSG ("Error! Unrecognized/unsupported node tag '" + tag + "' for scalar node '" + key + "'.\n"
           "  Supported tags: !!int, !!bool, !!float, !!str");
     }
+    EKAT_REQUIRE_MSG (is_compatible(v.kind,requested),
+        "Error! Tag " + tag + " not compatible with the stored value '" + str + "'\n");
+    set_scalar(list,key,str,v,requested);
   }
 }
 
@@ -151,71 +204,61 @@ void parse_node<YAML::NodeType::Sequence> (
   EKAT_REQUIRE_MSG (node.Type()==YAML::NodeType::Sequence,
                       "Error! Actual node type incompatible with template parameter.\n");
 
-  // The following fancy typemap/typelist code defeats the nvcc compiler(s)
-  // available on Summit, so we're backpedaling for now. The code below this
-  // block comment does the same thing. -JNJ, 5/27/2022
-  /*
-  // Loop over the value types, just to find the one corresponding to seq_type
-  using val_to_seq_val = TypeMap<values_t,seq_values_t>;
-  int n = node.size();
-  TypeListFor<values_t>([&](auto t)->bool {
-    using vtype = decltype(t);
-    if (is_seq<vtype>(node)) {
-      // Once we know the value type, create the proper std::vector, fill it, and set it in the list
-      using seq_val_t = val_to_seq_val::at_t<vtype>;
-      std::vector<seq_val_t> vec(n);
-      for (int i=0; i<n; ++i) {
-        std::string str = node[i].as<std::string>();
-        vec[i] = str2type<seq_val_t>(str);
-      }
-      list.set(key,vec);
-      // Returning true allows to immediately break from the TypeListFor
-      return true;
-    }
-    return false;
-  });
-  */
-  // Yes, I know. The C preprocessor! Too bad the fancy C++ template stuff
-  // isn't up to the task. Here we encode a value type and its related sequence
-  // type in the first two arguments in this macro, which we then call on all
-  // types in the typelist.
-#define TRY_TYPE_ON_NODE(vtype, seq_val_t, node) \
-  if (is_seq<vtype>(node)) { \
-    int n = node.size(); \
-    std::vector<seq_val_t> vec(n); \
-    for (int i=0; i<n; ++i) { \
-      std::string str = node[i].as<std::string>(); \
-      vec[i] = str2type<seq_val_t>(str); \
-    } \
-    list.set(key,vec); \
-    return; \
-  }
   const auto& tag = node.Tag();
+  ScalarKind requested;
   if (tag=="?") {
-    // There's no tag annotation regarding the node type,
-    // so we just try in order bool, int, double, string
-    TRY_TYPE_ON_NODE(bool, char, node);
-    TRY_TYPE_ON_NODE(int, int, node);
-    TRY_TYPE_ON_NODE(double, double, node);
-    TRY_TYPE_ON_NODE(std::string, std::string, node);
+    // There's no tag annotation regarding the node type, so we use the
+    // most specific type that can represent all entries. Empty sequences
+    // are stored as bools, like any other sequence whose entries are all bools.
+    requested = ScalarKind::Bool;
+  } else if (tag=="!bools") {
+    requested = ScalarKind::Bool;
+  } else if (tag=="!ints") {
+    requested = ScalarKind::Int;
+  } else if (tag=="!floats") {
+    requested = ScalarKind::Double;
+  } else if (tag=="!strings") {
+    requested = ScalarKind::String;
   } else {
-    // YAY, the user is telling us how to interpret the values
-    if (tag=="!bools") {
-      TRY_TYPE_ON_NODE(bool,char,node);
-    } else if (tag=="!ints") {
-      TRY_TYPE_ON_NODE(int,int,node);
-    } else if (tag=="!floats") {
-      TRY_TYPE_ON_NODE(double,double,node);
-    } else if (tag=="!strings") {
-      TRY_TYPE_ON_NODE(std::string,std::string,node);
-    } else {
-      EKAT_ERROR_MSG ("Error! Unrecognized/unsupported node tag.\n"
-          "  tag: " + tag + "\n"
-          "  supported tags: !ints, !bools, !floats, !strings");
+    EKAT_ERROR_MSG ("Error! Unrecognized/unsupported node tag.\n"
+        "  tag: " + tag + "\n"
+        "  supported tags: !ints, !bools, !floats, !strings");
+  }
+
+  // Classify each entry once, keeping the values
+  const int n = node.size();
+  std::vector<std::string> strs(n);
+  std::vector<ScalarValue> vals(n);
+  ScalarKind kind = ScalarKind::Bool;
+  for (int i=0; i<n; ++i) {
+    strs[i] = node[i].as<std::string>();
+    if (requested!=ScalarKind::String) {
+      vals[i] = classify_scalar(strs[i]);
+      kind = i==0 ? vals[i].kind : common_kind(kind,vals[i].kind);
     }
-    EKAT_ERROR_MSG ("Error! Tag '" + tag + "' was not compatible with the stored values.\n");
   }
-#undef TRY_TYPE_ON_NODE
+
+  if (tag=="?") {
+    requested = kind;
+  } else {
+    EKAT_REQUIRE_MSG (n==0 || is_compatible(kind,requested),
+        "Error! Tag '" + tag + "' was not compatible with the stored values.\n");
+  }
+
+  switch (requested) {
+    case ScalarKind::Bool:
+      list.set(key,fill_seq<char>(vals,[](const ScalarValue& v) -> char { return v.b ? 1 : 0; }));
+      break;
+    case ScalarKind::Int:
+      list.set(key,fill_seq<int>(vals,[](const ScalarValue& v) { return v.i; }));
+      break;
+    case ScalarKind::Double:
+      list.set(key,fill_seq<double>(vals,[](const ScalarValue& v) { return v.d; }));
+      break;
+    case ScalarKind::String:
+      list.set(key,strs);
+      break;
+  }
 }
 
 template<>
@@ -273,6 +316,208 @@ void parse_yaml_file (const std::string& fname, ParameterList& params) {
   params = temp.sublist(params.name());
 }
 
+ParameterList parse_yaml_file (const std::string& fname, const Comm& comm) {
+  ParameterList params;
+  parse_yaml_file(fname,params,comm);
+  return params;
+}
+
+// Call parse(params) on root only, and broadcast the result (in binary form)
+// to all other ranks. If parse throws on root, all ranks throw.
+template<typename ParseFunc>
+void parse_on_root_and_broadcast (const std::string& fname, ParameterList& params,
+                                  const Comm& comm, const ParseFunc& parse) {
+  // Root parses and serializes. A negative size signals a failure,
+  // so that non-root ranks do not hang waiting for the buffer.
+  std::vector<char> buffer;
+  std::string err_msg;
+  long long size = -1;
+  if (comm.am_i_root()) {
+    try {
+      parse(params);
+      buffer = serialize_parameter_list(params);
+      size = buffer.size();
+    } catch (std::exception& e) {
+      err_msg = e.what();
+    }
+  }
+
+  comm.broadcast(&size,1,comm.root_rank());
+  if (comm.am_i_root()) {
+    EKAT_REQUIRE_MSG (size>=0, err_msg);
+  } else {
+    EKAT_REQUIRE_MSG (size>=0,
+        "Error! Something went wrong while parsing file '" + fname + "' on root rank.\n");
+  }
+  EKAT_REQUIRE_MSG (size<=std::numeric_limits<int>::max(),
+      "Error! Serialized ParameterList is too large to be broadcast.\n"
+      "  - file name: " + fname + "\n"
+      "  - size     : " + std::to_string(size) + "\n");
+
+  buffer.resize(size);
+  comm.broadcast(buffer.data(),static_cast<int>(size),comm.root_rank());
+  if (not comm.am_i_root()) {
+    const auto name = params.name();
+    params = deserialize_parameter_list(buffer);
+    params.rename(name);
+  }
+}
+
+void parse_yaml_file (const std::string& fname, ParameterList& params, const Comm& comm) {
+  parse_on_root_and_broadcast(fname,params,comm,[&](ParameterList& pl) {
+    parse_yaml_file(fname,pl);
+  });
+}
+
+// Cache header: yaml file mtime (in ns) and size, and content hash
+struct YamlCacheStamp {
+  std::int64_t  mtime;
+  std::int64_t  size;
+  std::uint64_t hash;
+};
+
+// The file modification time, in nanoseconds
+std::int64_t mtime_ns (const struct stat& s) {
+#ifdef __APPLE__
+  const auto& t = s.st_mtimespec;
+#else
+  const auto& t = s.st_mtim;
+#endif
+  return static_cast<std::int64_t>(t.tv_sec)*1000000000 + t.tv_nsec;
+}
+
+// Read the whole file
+std::vector<char> read_yaml_file_bytes (const std::string& fname, const std::int64_t size) {
+  std::vector<char> bytes(size);
+  FILEPtr fid(fopen(fname.c_str(),"rb"));
+  EKAT_REQUIRE_MSG (fid, "Error! Something went wrong while opening file '" + fname + "'.\n");
+  read(bytes.data(),bytes.size(),fid);
+  return bytes;
+}
+
+// Read the cache header and (serialized) list, as well as the cache file mtime.
+// Return false if the cache file does not exist or is truncated.
+bool read_yaml_cache (const std::string& cache_fname, YamlCacheStamp& stamp,
+                      std::int64_t& cache_mtime, std::vector<char>& buffer) {
+  FILEPtr fid(fopen(cache_fname.c_str(),"rb"));
+  struct stat s;
+  if (not fid || fstat(fileno(fid.get()),&s)!=0 ||
+      std::fread(&stamp,sizeof(stamp),1,fid.get())!=1) {
+    return false;
+  }
+  cache_mtime = mtime_ns(s);
+
+  buffer.resize(s.st_size>static_cast<off_t>(sizeof(stamp)) ? s.st_size-sizeof(stamp) : 0);
+  return std::fread(buffer.data(),1,buffer.size(),fid.get())==buffer.size();
+}
+
+// Load the list from the serialized buffer. Return false if the buffer is
+// corrupted, or comes from a different format version.
+bool load_yaml_cache (const std::vector<char>& buffer, ParameterList& params) {
+  try {
+    const auto name = params.name();
+    params = deserialize_parameter_list(buffer);
+    params.rename(name);
+  } catch (std::exception&) {
+    return false;
+  }
+  return true;
+}
+
+// Write the cache to a temporary file, then rename it, so that concurrent
+// readers (e.g., other jobs using the same yaml file) never see a partially
+// written cache. Failures are silently ignored.
+void write_yaml_cache (const std::string& cache_fname, const YamlCacheStamp& stamp,
+                       const ParameterList& params) {
+  const auto buffer = serialize_parameter_list(params);
+
+  char host[256] = {0};
+  gethostname(host,sizeof(host)-1);
+  const auto tmp_fname = cache_fname + ".tmp." + host + "." + std::to_string(getpid());
+
+  FILEPtr fid(fopen(tmp_fname.c_str(),"wb"));
+  if (not fid) {
+    return;
+  }
+  bool ok = std::fwrite(&stamp,sizeof(stamp),1,fid.get())==1 &&
+            std::fwrite(buffer.data(),1,buffer.size(),fid.get())==buffer.size();
+  ok = std::fclose(fid.release())==0 && ok;
+  if (not ok || std::rename(tmp_fname.c_str(),cache_fname.c_str())!=0) {
+    std::remove(tmp_fname.c_str());
+  }
+}
+
+ParameterList parse_yaml_file_cached (const std::string& fname, const std::string& cache_fname) {
+  ParameterList params;
+  parse_yaml_file_cached(fname,params,cache_fname);
+  return params;
+}
+
+void parse_yaml_file_cached (const std::string& fname, ParameterList& params,
+                             const std::string& cache_fname) {
+  const auto cache = cache_fname.empty() ? fname + ".cache" : cache_fname;
+
+  struct stat s;
+  EKAT_REQUIRE_MSG (stat(fname.c_str(),&s)==0,
+      "Error! Something went wrong while opening file '" + fname + "'.\n");
+  YamlCacheStamp stamp;
+  stamp.mtime = mtime_ns(s);
+  stamp.size  = s.st_size;
+
+  YamlCacheStamp cached;
+  std::int64_t cache_mtime;
+  std::vector<char> buffer;
+  const bool have_cache = read_yaml_cache(cache,cached,cache_mtime,buffer);
+
+  // If mtime and size match, there is no need to read (and hash) the yaml file,
+  // unless it was modified shortly before the cache was written: a later change
+  // may then leave the mtime unchanged (if the file system has coarse timestamps).
+  const std::int64_t one_second = 1000000000;
+  if (have_cache && cached.mtime==stamp.mtime && cached.size==stamp.size &&
+      stamp.mtime+one_second<cache_mtime && load_yaml_cache(buffer,params)) {
+    return;
+  }
+
+  const auto bytes = read_yaml_file_bytes(fname,stamp.size);
+  stamp.hash = content_hash(bytes.data(),bytes.size());
+  if (have_cache && cached.size==stamp.size && cached.hash==stamp.hash &&
+      load_yaml_cache(buffer,params)) {
+    // Same content: only refresh the stamp, so that next time the mtime check suffices
+    if (cached.mtime!=stamp.mtime) {
+      write_yaml_cache(cache,stamp,params);
+    }
+    return;
+  }
+
+  // Parse from the bytes we already read
+  YAML::Node root;
+  try {
+    root = YAML::Load(std::string(bytes.data(),bytes.size()));
+  } catch (YAML::ParserException& e) {
+    EKAT_ERROR_MSG ("Error! Something went wrong while parsing file '" + fname + "'.\n"
+                    "  " + e.what() + "\n");
+  }
+  ParameterList temp(params.name());
+  parse_node<YAML::NodeType::Map> (root, temp.name(), temp);
+  params = temp.sublist(params.name());
+
+  write_yaml_cache(cache,stamp,params);
+}
+
+ParameterList parse_yaml_file_cached (const std::string& fname, const Comm& comm,
+                                      const std::string& cache_fname) {
+  ParameterList params;
+  parse_yaml_file_cached(fname,params,comm,cache_fname);
+  return params;
+}
+
+void parse_yaml_file_cached (const std::string& fname, ParameterList& params,
+                             const Comm& comm, const std::string& cache_fname) {
+  parse_on_root_and_broadcast(fname,params,comm,[&](ParameterList& pl) {
+    parse_yaml_file_cached(fname,pl,cache_fname);
+  });
+}
+
 // =============================== WRITE ============================ //
 
 // Helper functions to allow printing values correctly. In particular:
@@ -2,6 +2,8 @@
 #define EKAT_YAML_HPP
 
 #include "ekat/ekat_parameter_list.hpp"
+#include "ekat/mpi/ekat_comm.hpp"
+
 #include <string>
 
 namespace ekat {
@@ -24,11 +26,38 @@ namespace ekat {
  * parser functions: bool, int, double, std::string, std::vector<char>, std::vector<int>,
  * std::vector<double>, std::vector<std::string>. If any other type is found,
  * an exception will be thrown.
+ *
+ * The overloads taking a Comm are collective: only the root rank reads and parses
+ * the file, and the resulting ParameterList is broadcast (in binary form, see
+ * ekat_parameter_list_serialization.hpp) to all other ranks. If parsing fails on
+ * the root rank, an exception is thrown on all ranks.
+ *
+ * The cached versions store the parsed list in binary form in a cache file
+ * (by default, the YAML file name with ".cache" appended), together with the
+ * modification time, size, and content hash of the YAML file. If mtime and size
+ * still match, the list is loaded from the cache, without reading the YAML file.
+ * Otherwise (or if the YAML file was modified right before the cache was written),
+ * the YAML file is read, and its content hash is compared with the cached one.
+ * If they differ, the file is parsed and the cache (re)written. The cache is
+ * written to a temporary file and then renamed, so that readers never see a
+ * partially written cache. Failure to write the cache is not an error.
+ * The collective cached versions only access the cache on the root rank.
+ * NOTE: changes that preserve both the size and the mtime of the YAML file
+ *       (e.g., 'touch -r') are not detected.
  */
 
 ParameterList parse_yaml_file (const std::string& fname);
 void parse_yaml_file (const std::string& fname, ParameterList& params);
 
+ParameterList parse_yaml_file (const std::string& fname, const Comm& comm);
+void parse_yaml_file (const std::string& fname, ParameterList& params, const Comm& comm);
+
+ParameterList parse_yaml_file_cached (const std::string& fname, const std::string& cache_fname = "");
+void parse_yaml_file_cached (const std::string& fname, ParameterList& params, const std::string& cache_fname = "");
+
+ParameterList parse_yaml_file_cached (const std::string& fname, const Comm& comm, const std::string& cache_fname = "");
+void parse_yaml_file_cached (const std::string& fname, ParameterList& params, const Comm& comm, const std::string& cache_fname = "");
+
 void write_yaml_file (const std::string& fname, const ParameterList& params);
 
 } // namespace ekat
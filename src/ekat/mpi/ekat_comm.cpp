@@ -2,10 +2,115 @@
 #include "ekat/ekat_assert.hpp"
 
 #include <cassert>
+#include <map>
+#include <utility>
 
 namespace ekat
 {
 
+// ========================== CommRequest ========================== //
+
+CommRequest::CommRequest (CommRequest&& src)
+ : m_request(src.m_request)
+{
+  src.m_request = MPI_REQUEST_NULL;
+}
+
+CommRequest& CommRequest::operator= (CommRequest&& src)
+{
+  if (this!=&src) {
+    wait();
+    m_request = src.m_request;
+    src.m_request = MPI_REQUEST_NULL;
+  }
+  return *this;
+}
+
+void CommRequest::wait ()
+{
+  if (m_request!=MPI_REQUEST_NULL) {
+    CommStatsTimer timer("wait",0);
+    MPI_Wait(&m_request,MPI_STATUS_IGNORE);
+  }
+}
+
+bool CommRequest::test ()
+{
+  if (m_request==MPI_REQUEST_NULL) {
+    return true;
+  }
+  int flag;
+  MPI_Test(&m_request,&flag,MPI_STATUS_IGNORE);
+  return flag!=0;
+}
+
+void wait_all (std::vector<CommRequest>& requests)
+{
+  CommStatsTimer timer("wait",0);
+  std::vector<MPI_Request> mpi_requests;
+  mpi_requests.reserve(requests.size());
+  for (auto& r : requests) {
+    mpi_requests.push_back(r.mpi_request());
+  }
+  MPI_Waitall(mpi_requests.size(),mpi_requests.data(),MPI_STATUSES_IGNORE);
+  for (auto& r : requests) {
+    // All completed: reset the handles, so they don't wait again
+    r.mpi_request() = MPI_REQUEST_NULL;
+  }
+}
+
+// ============================ NodeComms ============================ //
+
+struct Comm::NodeComms
+{
+  ~NodeComms ()
+  {
+    int finalized;
+    MPI_Finalized(&finalized);
+    if (not finalized) {
+      MPI_Comm_free(&node);
+      if (leaders!=MPI_COMM_NULL) {
+        MPI_Comm_free(&leaders);
+      }
+    }
+  }
+
+  MPI_Comm node    = MPI_COMM_NULL;  // The ranks on this node
+  MPI_Comm leaders = MPI_COMM_NULL;  // The node leaders (null on other ranks)
+
+  // For each rank of the comm, the index of its node (i.e., the rank of
+  // its node leader in the leaders comm), and its rank within the node
+  std::vector<int> node_id;
+  std::vector<int> node_rank;
+};
+
+// ============================ CommData ============================ //
+
+struct Comm::CommData
+{
+  ~CommData ()
+  {
+    // Release the cached comms before freeing their parent
+    splits.clear();
+
+    int finalized;
+    MPI_Finalized(&finalized);
+    if (owned && not finalized) {
+      MPI_Comm_free(&comm);
+    }
+  }
+
+  MPI_Comm  comm  = MPI_COMM_NULL;
+  bool      owned = false;
+
+  // The comms created by cached_split, keyed on (color,key), together with
+  // the index of the cached_split call that created them
+  std::map<std::pair<int,int>,std::pair<int,Comm>> splits;
+  int num_splits = 0;
+};
+
+// ============================= Comm ============================== //
+
 Comm::Comm()
 {
   check_mpi_inited();
@@ -24,6 +129,10 @@ void Comm::reset_mpi_comm (MPI_Comm new_mpi_comm)
       "Error! ekat::Comm requires non-null MPI comm.");
 
   m_mpi_comm = new_mpi_comm;
+  m_node_comms.reset();
+  m_data = std::make_shared<CommData>();
+  m_data->comm = new_mpi_comm;
+  m_collective_mode = CollectiveMode::Flat;
 
   MPI_Comm_size(m_mpi_comm,&m_size);
   MPI_Comm_rank(m_mpi_comm,&m_rank);
@@ -35,22 +144,194 @@ void Comm::reset_mpi_comm (MPI_Comm new_mpi_comm)
 #endif
 }
 
+void Comm::set_collective_mode (const CollectiveMode mode)
+{
+  if (mode==CollectiveMode::Hierarchical && m_node_comms==nullptr) {
+    check_mpi_inited();
+
+    auto nc = std::make_shared<NodeComms>();
+    MPI_Comm_split_type(m_mpi_comm,MPI_COMM_TYPE_SHARED,m_rank,MPI_INFO_NULL,&nc->node);
+    int node_rank;
+    MPI_Comm_rank(nc->node,&node_rank);
+    MPI_Comm_split(m_mpi_comm,node_rank==0 ? 0 : MPI_UNDEFINED,m_rank,&nc->leaders);
+
+    // Let all ranks know the node of every other rank
+    int my_ids[2] = {0, node_rank};
+    if (nc->leaders!=MPI_COMM_NULL) {
+      MPI_Comm_rank(nc->leaders,&my_ids[0]);
+    }
+    MPI_Bcast(&my_ids[0],1,MPI_INT,0,nc->node);
+
+    std::vector<int> ids(2*m_size);
+    MPI_Allgather(my_ids,2,MPI_INT,ids.data(),2,MPI_INT,m_mpi_comm);
+    nc->node_id.resize(m_size);
+    nc->node_rank.resize(m_size);
+    for (int r=0; r<m_size; ++r) {
+      nc->node_id[r]   = ids[2*r];
+      nc->node_rank[r] = ids[2*r+1];
+    }
+
+    m_node_comms = nc;
+  }
+  m_collective_mode = mode;
+}
+
+void Comm::hierarchical_all_reduce (const void* send_vals, void* recv_vals, const int count,
+                                    const MPI_Datatype type, const MPI_Op op) const
+{
+  const auto& nc = *m_node_comms;
+  const bool am_i_leader = nc.leaders!=MPI_COMM_NULL;
+
+  // Reduce on the node leader, then across leaders, then broadcast within the node
+  if (send_vals==MPI_IN_PLACE && not am_i_leader) {
+    MPI_Reduce(recv_vals,nullptr,count,type,op,0,nc.node);
+  } else {
+    MPI_Reduce(send_vals,recv_vals,count,type,op,0,nc.node);
+  }
+  if (am_i_leader) {
+    MPI_Allreduce(MPI_IN_PLACE,recv_vals,count,type,op,nc.leaders);
+  }
+  MPI_Bcast(recv_vals,count,type,0,nc.node);
+}
+
+void Comm::hierarchical_broadcast (void* vals, const int count,
+                                   const MPI_Datatype type, const int root) const
+{
+  const auto& nc = *m_node_comms;
+  const int root_node = nc.node_id[root];
+  const bool on_root_node = nc.node_id[m_rank]==root_node;
+
+  // Broadcast within the root node, then across leaders, then within the other nodes
+  if (on_root_node) {
+    MPI_Bcast(vals,count,type,nc.node_rank[root],nc.node);
+  }
+  if (nc.leaders!=MPI_COMM_NULL) {
+    MPI_Bcast(vals,count,type,root_node,nc.leaders);
+  }
+  if (not on_root_node) {
+    MPI_Bcast(vals,count,type,0,nc.node);
+  }
+}
+
 void Comm::barrier () const
 {
+  CommStatsTimer timer("barrier",0);
   check_mpi_inited();
   MPI_Barrier(m_mpi_comm);
 }
 
 Comm Comm::split (const int color) const
 {
+  return split(color,m_rank);
+}
+
+Comm Comm::split (const int color, const int key) const
+{
+  CommStatsTimer timer("split",0);
   check_mpi_inited ();
 
   MPI_Comm new_comm;
-  MPI_Comm_split(m_mpi_comm,color,m_rank,&new_comm);
+  MPI_Comm_split(m_mpi_comm,color,key,&new_comm);
 
   return Comm(new_comm);
 }
 
+Comm Comm::cached_split (const int color) const
+{
+  return cached_split(color,m_rank);
+}
+
+Comm Comm::cached_split (const int color, const int key) const
+{
+  CommStatsTimer timer("cached_split",0);
+  check_mpi_inited ();
+
+  // The partition of the ranks only depends on the color/key of all ranks. So if
+  // all ranks find a comm created by the same cached_split call, then all ranks
+  // passed the same color/key as in that call, and the cached comms can be reused.
+  // We check that with one all_reduce, computing min and max of the call index.
+  auto& splits = m_data->splits;
+  auto it = splits.find(std::make_pair(color,key));
+  int ids[2] = {-1, 1};
+  if (it!=splits.end()) {
+    ids[0] = it->second.first;
+    ids[1] = -ids[0];
+  }
+  MPI_Allreduce(MPI_IN_PLACE,ids,2,MPI_INT,MPI_MIN,m_mpi_comm);
+  if (ids[0]>=0 && ids[0]==-ids[1]) {
+    return it->second.second;
+  }
+
+  // All ranks agree it's a miss, and increment the call index consistently
+  auto c = split(color,key);
+  c.own_mpi_comm();
+  splits.erase(std::make_pair(color,key));
+  splits.emplace(std::make_pair(color,key),std::make_pair(m_data->num_splits++,c));
+  return c;
+}
+
+void Comm::clear_split_cache ()
+{
+  m_data->splits.clear();
+}
+
+bool Comm::owns_mpi_comm () const
+{
+  return m_data->owned;
+}
+
+void Comm::own_mpi_comm ()
+{
+  EKAT_REQUIRE_MSG (m_mpi_comm!=MPI_COMM_WORLD && m_mpi_comm!=MPI_COMM_SELF,
+      "Error! Cannot take ownership of a predefined MPI comm.\n");
+  m_data->owned = true;
+}
+
+CommCounts Comm::all_gather_counts (const int my_count) const
+{
+  CommStatsTimer timer("all_gather_counts",sizeof(int));
+  std::vector<int> counts(m_size);
+  all_gather(&my_count,counts.data(),1);
+  return CommCounts(counts);
+}
+
+CommCounts Comm::all_to_all_counts (const CommCounts& send_counts) const
+{
+  check_mpi_inited();
+  check_counts(send_counts);
+  CommStatsTimer timer("all_to_all_counts",m_size*sizeof(int));
+
+  std::vector<int> counts(m_size);
+  MPI_Alltoall(send_counts.counts.data(),1,MPI_INT,
+               counts.data(),1,MPI_INT,m_mpi_comm);
+  return CommCounts(counts);
+}
+
+Comm Comm::split_shared () const
+{
+  CommStatsTimer timer("split_shared",0);
+  check_mpi_inited ();
+
+  MPI_Comm new_comm;
+  MPI_Comm_split_type(m_mpi_comm,MPI_COMM_TYPE_SHARED,m_rank,MPI_INFO_NULL,&new_comm);
+
+  return Comm(new_comm);
+}
+
+Comm Comm::split_node_leaders () const
+{
+  CommStatsTimer timer("split_node_leaders",0);
+  check_mpi_inited ();
+
+  MPI_Comm shared_comm;
+  MPI_Comm_split_type(m_mpi_comm,MPI_COMM_TYPE_SHARED,m_rank,MPI_INFO_NULL,&shared_comm);
+  int node_rank;
+  MPI_Comm_rank(shared_comm,&node_rank);
+  MPI_Comm_free(&shared_comm);
+
+  return split(node_rank);
+}
+
 void Comm::check_mpi_inited () const
 {
   int flag;
@@ -58,6 +339,16 @@ void Comm::check_mpi_inited () const
   assert (flag!=0);
 }
 
+void Comm::check_counts (const CommCounts& counts) const
+{
+  EKAT_REQUIRE_MSG (static_cast<int>(counts.counts.size())==m_size &&
+                    static_cast<int>(counts.displs.size())==m_size,
+      "Error! Counts and displacements must have one entry per rank.\n"
+      "  - comm size: " << m_size << "\n"
+      "  - num counts: " << counts.counts.size() << "\n"
+      "  - num displs: " << counts.displs.size() << "\n");
+}
+
 template<>
 MPI_Datatype get_mpi_type <char> () {
   return MPI_CHAR;
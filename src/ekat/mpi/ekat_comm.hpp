@@ -2,13 +2,16 @@
 #define EKAT_COMM_HPP
 
 #include <ekat/ekat_config.h>
+#include "ekat/mpi/ekat_comm_stats.hpp"
 
+#include <algorithm>
+#include <memory>
 #include <type_traits>
+#include <vector>
 
 #ifdef EKAT_ENABLE_MPI
 #include <mpi.h>
 #else
-#include <algorithm> // for std::copy
 // These are stand-ins for the MPI data types that appear in Comm's interface.
 enum MPI_Comm {
   MPI_COMM_NULL,
@@ -48,11 +51,94 @@ enum MPI_Op {
 namespace ekat
 {
 
+// A handle to a pending nonblocking communication (see the i* methods of Comm).
+// The handle owns the request: if it goes out of scope before the operation
+// completed, the destructor waits for it. Handles can be moved, but not copied.
+// A default-constructed handle refers to an already completed operation.
+// NOTE: when MPI is not enabled, all operations complete immediately.
+
+class CommRequest
+{
+public:
+  CommRequest () = default;
+#ifdef EKAT_ENABLE_MPI
+  explicit CommRequest (const MPI_Request& request) : m_request(request) {}
+#endif
+
+  CommRequest (const CommRequest&) = delete;
+  CommRequest& operator= (const CommRequest&) = delete;
+  CommRequest (CommRequest&& src);
+  CommRequest& operator= (CommRequest&& src);
+
+  ~CommRequest () { wait(); }
+
+  // Block until the operation completes
+  void wait ();
+
+  // Return true if the operation completed (without blocking)
+  bool test ();
+
+#ifdef EKAT_ENABLE_MPI
+  MPI_Request& mpi_request () { return m_request; }
+#endif
+
+private:
+#ifdef EKAT_ENABLE_MPI
+  MPI_Request m_request = MPI_REQUEST_NULL;
+#endif
+};
+
+// Wait for all the given requests to complete
+void wait_all (std::vector<CommRequest>& requests);
+
+inline void wait_all () {}
+
+template<typename... Requests>
+void wait_all (CommRequest& request, Requests&... requests) {
+  request.wait();
+  wait_all(requests...);
+}
+
+// Per-rank counts and displacements (in number of entries), for the variable-count
+// collectives of Comm. By default, displacements are the exclusive prefix sum of
+// the counts, so that the entries of all ranks are contiguous, and in rank order.
+struct CommCounts
+{
+  CommCounts () = default;
+  explicit CommCounts (const std::vector<int>& c)
+   : counts (c)
+   , displs (c.size(),0)
+  {
+    for (size_t i=1; i<counts.size(); ++i) {
+      displs[i] = displs[i-1] + counts[i-1];
+    }
+  }
+
+  // The number of entries needed to store all ranks' entries
+  int total () const {
+    int n = 0;
+    for (size_t i=0; i<counts.size(); ++i) {
+      n = std::max(n,displs[i]+counts[i]);
+    }
+    return n;
+  }
+
+  std::vector<int> counts;
+  std::vector<int> displs;
+};
+
 // A small wrapper around an MPI_Comm, together with its rank/size
 
 // NOTE: this class checks that MPI is already init-ed, and errors out
 //       if it is not. It is YOUR responsibility to make sure MPI is
 //       init-ed before you create a ekat::Comm
+// NOTE: copies of a Comm share the same MPI_Comm. By default, a Comm does not
+//       own its MPI_Comm, and it is YOUR responsibility to free it (this
+//       includes the comms returned by split, split_shared, and
+//       split_node_leaders). A Comm that owns its MPI_Comm (see own_mpi_comm,
+//       and cached_split) frees it (if MPI is not finalized yet) when the last
+//       copy is destroyed. Since MPI_Comm_free is collective, this must happen
+//       on all ranks of the comm.
 
 class Comm
 {
@@ -82,9 +168,28 @@ public:
   int  size () const { return m_size; }
   MPI_Comm mpi_comm () const { return m_mpi_comm; }
 
+  // The algorithm used by the (blocking) all_reduce and broadcast methods.
+  // In hierarchical mode, the operation is first performed among the ranks
+  // of each node (see split_shared), then among the node leaders, and
+  // finally the result is broadcast within each node. This can be faster
+  // than the flat version for small messages on many ranks.
+  // NOTE: the hierarchical reduction combines values in a different order,
+  //       so the op must be commutative, and results of floating point
+  //       sums may differ in the last bits from the flat version.
+  enum class CollectiveMode {
+    Flat,
+    Hierarchical
+  };
+
+  // Collective on this comm (the node comms are created once, and shared
+  // by all copies of this Comm made after this call).
+  void set_collective_mode (const CollectiveMode mode);
+  CollectiveMode get_collective_mode () const { return m_collective_mode; }
+
   // Convenience functions wrapping MPI analogues.
-  // NOTE: the methods are templated on the values types, but so far the only
-  // supporterd types are: int, float, double
+  // NOTE: the methods are templated on the values types. Builtin types are
+  // supported, and other types can be added via get_mpi_type/MpiTypeTraits.
+  // For collectives on Kokkos views, see ekat_comm_kokkos.hpp.
 
   template<typename T>
   void broadcast (T* vals, const int count, const int root) const;
@@ -108,40 +213,196 @@ public:
   template<typename T>
   void all_gather (T* all_vals, const int count) const;
 
+  // Nonblocking versions of the above. The input/output buffers must not be
+  // touched until the returned request has completed. If the request is
+  // discarded, the call is effectively blocking (see CommRequest).
+
+  template<typename T>
+  CommRequest ibroadcast (T* vals, const int count, const int root) const;
+
+  template<typename T>
+  CommRequest iscan (const T* my_vals, T* result, const int count, const MPI_Op op) const;
+
+  template<typename T>
+  CommRequest iall_reduce (const T* my_vals, T* result, const int count, const MPI_Op op) const;
+
+  template<typename T>
+  CommRequest iall_gather (const T* my_vals, T* all_vals, const int count) const;
+
+  template<typename T>
+  CommRequest iscan (T* result, const int count, const MPI_Op op) const;
+
+  template<typename T>
+  CommRequest iall_reduce (T* inout_vals, const int count, const MPI_Op op) const;
+
+  template<typename T>
+  CommRequest iall_gather (T* all_vals, const int count) const;
+
+  // Variable-count versions of the collectives. The counts/displs of each rank
+  // are stored in a CommCounts object, which can be built with the methods
+  // below (or by hand). In gatherv/scatterv, only the root needs them, except
+  // in the in-place versions, where each rank's entries are the ones at its
+  // displacement in the (global) all_vals array.
+
+  // Gather my_count (one small all_gather), and compute contiguous displacements
+  CommCounts all_gather_counts (const int my_count) const;
+
+  // Given the counts this rank sends to each rank, compute the counts
+  // this rank receives from each rank (one small all_to_all)
+  CommCounts all_to_all_counts (const CommCounts& send_counts) const;
+
+  template<typename T>
+  void gatherv (const T* my_vals, const int my_count, T* all_vals,
+                const CommCounts& counts, const int root) const;
+
+  template<typename T>
+  void all_gatherv (const T* my_vals, const int my_count, T* all_vals,
+                    const CommCounts& counts) const;
+
+  template<typename T>
+  void scatterv (const T* all_vals, const CommCounts& counts,
+                 T* my_vals, const int my_count, const int root) const;
+
+  template<typename T>
+  void all_to_allv (const T* send_vals, const CommCounts& send_counts,
+                    T* recv_vals, const CommCounts& recv_counts) const;
+
+  // In place version of the above. For all_to_allv, the same counts are used
+  // for both sent and received entries.
+  template<typename T>
+  void gatherv (T* all_vals, const CommCounts& counts, const int root) const;
+
+  template<typename T>
+  void all_gatherv (T* all_vals, const CommCounts& counts) const;
+
+  template<typename T>
+  void scatterv (T* all_vals, const CommCounts& counts, const int root) const;
+
+  template<typename T>
+  void all_to_allv (T* vals, const CommCounts& counts) const;
+
   void barrier () const;
 
+  // Split into comms of ranks with the same color, ordered by key (by default,
+  // the rank in this comm). The returned Comm does NOT own the new MPI_Comm,
+  // so that the MPI_Comm stays valid after the Comm goes out of scope (e.g.,
+  // in MPI_Comm c = comm.split(color).mpi_comm()). Call own_mpi_comm on it
+  // to have it freed automatically, or use cached_split.
   Comm split (const int color) const;
+  Comm split (const int color, const int key) const;
+
+  // Same as split, but if all ranks pass the same color/key as in a previous
+  // cached_split call on this comm (or a copy of it), the Comm returned by that
+  // call is returned again, rather than creating a new MPI_Comm. Checking that
+  // all ranks agree costs a small all_reduce, which is much cheaper than a split.
+  // The returned Comm owns its MPI_Comm: cached comms are kept alive until the
+  // cache is cleared, or the last copy of this comm is destroyed (or reset),
+  // and then freed once all copies of the returned Comm are destroyed.
+  Comm cached_split (const int color) const;
+  Comm cached_split (const int color, const int key) const;
+  void clear_split_cache ();
+
+  // Whether the MPI_Comm is freed when the last copy of this Comm is destroyed
+  bool owns_mpi_comm () const;
+
+  // Make this Comm (and all its copies) own the MPI_Comm, which is then freed
+  // when the last copy is destroyed. The MPI_Comm must not be freed elsewhere,
+  // and cannot be one of the predefined comms.
+  void own_mpi_comm ();
+
+  // Split into comms of ranks that can create shared memory (i.e., the ranks on
+  // the same node). Within each new comm, ranks keep the same relative order,
+  // so this rank 0 is the "node leader". As for split, the returned Comm does
+  // not own its MPI_Comm.
+  Comm split_shared () const;
+
+  // Split into comms of ranks with the same node-local rank (see split_shared).
+  // On node leaders, this is the comm of all the node leaders.
+  Comm split_node_leaders () const;
 private:
 
   // Checks (with an assert) that MPI is already init-ed.
   void check_mpi_inited () const;
 
+  // Checks that counts/displs have one entry per rank
+  void check_counts (const CommCounts& counts) const;
+
+  // Implementation of the hierarchical collectives (send_vals can be MPI_IN_PLACE)
+  void hierarchical_all_reduce (const void* send_vals, void* recv_vals, const int count,
+                                const MPI_Datatype type, const MPI_Op op) const;
+  void hierarchical_broadcast (void* vals, const int count,
+                               const MPI_Datatype type, const int root) const;
+
+  // The node and node-leaders comms used in hierarchical mode
+  struct NodeComms;
+  std::shared_ptr<NodeComms>  m_node_comms;
+
+  // Data shared by all copies of this Comm: ownership of the MPI_Comm,
+  // and the comms created by cached_split
+  struct CommData;
+  std::shared_ptr<CommData>   m_data;
+  CollectiveMode              m_collective_mode = CollectiveMode::Flat;
+
   MPI_Comm  m_mpi_comm;
 
   int       m_size;
   int       m_rank;
 };
 
+// Traits used to communicate values of type T. Builtin types (and user types for
+// which get_mpi_type is explicitly specialized) do not need to specialize this class.
+// Since function templates cannot be partially specialized, class templates (such as
+// ekat::Pack, see ekat_comm_kokkos.hpp) specialize this class instead, providing
+//  - static MPI_Datatype mpi_type (): the datatype used to move T values around;
+//  - scalar_type and size: a T is made of size values of type scalar_type.
+// Reductions and scans operate on the scalar_type values, since MPI predefined
+// ops cannot be applied to derived datatypes. E.g., packs are reduced entry-wise.
 template<typename T>
-MPI_Datatype get_mpi_type ();
+struct MpiTypeTraits {
+  using scalar_type = T;
+  static constexpr int size = 1;
+};
+
+template<typename T>
+MPI_Datatype get_mpi_type () {
+  return MpiTypeTraits<T>::mpi_type();
+}
+
+template<> MPI_Datatype get_mpi_type<char> ();
+template<> MPI_Datatype get_mpi_type<short> ();
+template<> MPI_Datatype get_mpi_type<int> ();
+template<> MPI_Datatype get_mpi_type<long> ();
+template<> MPI_Datatype get_mpi_type<long long> ();
+template<> MPI_Datatype get_mpi_type<float> ();
+template<> MPI_Datatype get_mpi_type<double> ();
+#if MPI_VERSION>3 || (MPI_VERSION==3 && MPI_SUBVERSION>=1)
+template<> MPI_Datatype get_mpi_type<bool> ();
+#endif
 
 // ========================= IMPLEMENTATION =========================== //
 
 template<typename T>
 void Comm::broadcast (T* vals, const int count, const int root) const
 {
+  CommStatsTimer timer("broadcast",count*sizeof(T));
 #ifdef EKAT_ENABLE_MPI
   check_mpi_inited();
-  MPI_Bcast(vals,count,get_mpi_type<T>(),root,m_mpi_comm);
+  if (m_collective_mode==CollectiveMode::Hierarchical) {
+    hierarchical_broadcast(vals,count,get_mpi_type<T>(),root);
+  } else {
+    MPI_Bcast(vals,count,get_mpi_type<T>(),root,m_mpi_comm);
+  }
 #endif
 }
 
 template<typename T>
 void Comm::scan (const T* my_vals, T* result, const int count, const MPI_Op op) const
 {
+  CommStatsTimer timer("scan",count*sizeof(T));
 #ifdef EKAT_ENABLE_MPI
   check_mpi_inited();
-  MPI_Scan(my_vals,result,count,get_mpi_type<T>(),op,m_mpi_comm);
+  using traits = MpiTypeTraits<T>;
+  MPI_Scan(my_vals,result,count*traits::size,get_mpi_type<typename traits::scalar_type>(),op,m_mpi_comm);
 #else
   std::copy(my_vals, my_vals + count, result);
 #endif
@@ -150,9 +411,16 @@ void Comm::scan (const T* my_vals, T* result, const int count, const MPI_Op op)
 template<typename T>
 void Comm::all_reduce (const T* my_vals, T* result, const int count, const MPI_Op op) const
 {
+  CommStatsTimer timer("all_reduce",count*sizeof(T));
 #ifdef EKAT_ENABLE_MPI
   check_mpi_inited();
-  MPI_Allreduce(my_vals,result,count,get_mpi_type<T>(),op,m_mpi_comm);
+  using traits = MpiTypeTraits<T>;
+  const auto mpi_type = get_mpi_type<typename traits::scalar_type>();
+  if (m_collective_mode==CollectiveMode::Hierarchical) {
+    hierarchical_all_reduce(my_vals,result,count*traits::size,mpi_type,op);
+  } else {
+    MPI_Allreduce(my_vals,result,count*traits::size,mpi_type,op,m_mpi_comm);
+  }
 #else
   std::copy(my_vals, my_vals + count, result);
 #endif
@@ -161,6 +429,7 @@ void Comm::all_reduce (const T* my_vals, T* result, const int count, const MPI_O
 template<typename T>
 void Comm::all_gather (const T* my_vals, T* all_vals, const int count) const
 {
+  CommStatsTimer timer("all_gather",count*sizeof(T));
 #ifdef EKAT_ENABLE_MPI
   check_mpi_inited();
   auto mpi_type = get_mpi_type<T>();
@@ -175,24 +444,34 @@ void Comm::all_gather (const T* my_vals, T* all_vals, const int count) const
 template<typename T>
 void Comm::scan (T* inout_vals, const int count, const MPI_Op op) const
 {
+  CommStatsTimer timer("scan",count*sizeof(T));
 #ifdef EKAT_ENABLE_MPI
   check_mpi_inited();
-  MPI_Scan(MPI_IN_PLACE,inout_vals,count,get_mpi_type<T>(),op,m_mpi_comm);
+  using traits = MpiTypeTraits<T>;
+  MPI_Scan(MPI_IN_PLACE,inout_vals,count*traits::size,get_mpi_type<typename traits::scalar_type>(),op,m_mpi_comm);
 #endif
 }
 
 template<typename T>
 void Comm::all_reduce (T* inout_vals, const int count, const MPI_Op op) const
 {
+  CommStatsTimer timer("all_reduce",count*sizeof(T));
 #ifdef EKAT_ENABLE_MPI
   check_mpi_inited();
-  MPI_Allreduce(MPI_IN_PLACE,inout_vals,count,get_mpi_type<T>(),op,m_mpi_comm);
+  using traits = MpiTypeTraits<T>;
+  const auto mpi_type = get_mpi_type<typename traits::scalar_type>();
+  if (m_collective_mode==CollectiveMode::Hierarchical) {
+    hierarchical_all_reduce(MPI_IN_PLACE,inout_vals,count*traits::size,mpi_type,op);
+  } else {
+    MPI_Allreduce(MPI_IN_PLACE,inout_vals,count*traits::size,mpi_type,op,m_mpi_comm);
+  }
 #endif
 }
 
 template<typename T>
 void Comm::all_gather (T* inout_vals, const int count) const
 {
+  CommStatsTimer timer("all_gather",count*sizeof(T));
 #ifdef EKAT_ENABLE_MPI
   check_mpi_inited();
   auto mpi_type = get_mpi_type<T>();
@@ -202,6 +481,269 @@ void Comm::all_gather (T* inout_vals, const int count) const
 #endif
 }
 
+template<typename T>
+CommRequest Comm::ibroadcast (T* vals, const int count, const int root) const
+{
+  CommStatsTimer timer("ibroadcast",count*sizeof(T));
+#ifdef EKAT_ENABLE_MPI
+  check_mpi_inited();
+  CommRequest req;
+  MPI_Ibcast(vals,count,get_mpi_type<T>(),root,m_mpi_comm,&req.mpi_request());
+  return req;
+#else
+  return CommRequest();
+#endif
+}
+
+template<typename T>
+CommRequest Comm::iscan (const T* my_vals, T* result, const int count, const MPI_Op op) const
+{
+  CommStatsTimer timer("iscan",count*sizeof(T));
+#ifdef EKAT_ENABLE_MPI
+  check_mpi_inited();
+  CommRequest req;
+  using traits = MpiTypeTraits<T>;
+  MPI_Iscan(my_vals,result,count*traits::size,get_mpi_type<typename traits::scalar_type>(),op,m_mpi_comm,&req.mpi_request());
+  return req;
+#else
+  std::copy(my_vals, my_vals + count, result);
+  return CommRequest();
+#endif
+}
+
+template<typename T>
+CommRequest Comm::iall_reduce (const T* my_vals, T* result, const int count, const MPI_Op op) const
+{
+  CommStatsTimer timer("iall_reduce",count*sizeof(T));
+#ifdef EKAT_ENABLE_MPI
+  check_mpi_inited();
+  CommRequest req;
+  using traits = MpiTypeTraits<T>;
+  MPI_Iallreduce(my_vals,result,count*traits::size,get_mpi_type<typename traits::scalar_type>(),op,m_mpi_comm,&req.mpi_request());
+  return req;
+#else
+  std::copy(my_vals, my_vals + count, result);
+  return CommRequest();
+#endif
+}
+
+template<typename T>
+CommRequest Comm::iall_gather (const T* my_vals, T* all_vals, const int count) const
+{
+  CommStatsTimer timer("iall_gather",count*sizeof(T));
+#ifdef EKAT_ENABLE_MPI
+  check_mpi_inited();
+  CommRequest req;
+  auto mpi_type = get_mpi_type<T>();
+  MPI_Iallgather(my_vals, count,mpi_type,
+                 all_vals,count,mpi_type,
+                 m_mpi_comm,&req.mpi_request());
+  return req;
+#else
+  std::copy(my_vals, my_vals + count, all_vals);
+  return CommRequest();
+#endif
+}
+
+template<typename T>
+CommRequest Comm::iscan (T* inout_vals, const int count, const MPI_Op op) const
+{
+  CommStatsTimer timer("iscan",count*sizeof(T));
+#ifdef EKAT_ENABLE_MPI
+  check_mpi_inited();
+  CommRequest req;
+  using traits = MpiTypeTraits<T>;
+  MPI_Iscan(MPI_IN_PLACE,inout_vals,count*traits::size,get_mpi_type<typename traits::scalar_type>(),op,m_mpi_comm,&req.mpi_request());
+  return req;
+#else
+  return CommRequest();
+#endif
+}
+
+template<typename T>
+CommRequest Comm::iall_reduce (T* inout_vals, const int count, const MPI_Op op) const
+{
+  CommStatsTimer timer("iall_reduce",count*sizeof(T));
+#ifdef EKAT_ENABLE_MPI
+  check_mpi_inited();
+  CommRequest req;
+  using traits = MpiTypeTraits<T>;
+  MPI_Iallreduce(MPI_IN_PLACE,inout_vals,count*traits::size,get_mpi_type<typename traits::scalar_type>(),op,m_mpi_comm,&req.mpi_request());
+  return req;
+#else
+  return CommRequest();
+#endif
+}
+
+template<typename T>
+CommRequest Comm::iall_gather (T* inout_vals, const int count) const
+{
+  CommStatsTimer timer("iall_gather",count*sizeof(T));
+#ifdef EKAT_ENABLE_MPI
+  check_mpi_inited();
+  CommRequest req;
+  auto mpi_type = get_mpi_type<T>();
+  MPI_Iallgather(MPI_IN_PLACE, 0, MPI_DATATYPE_NULL,
+                 inout_vals,count,mpi_type,
+                 m_mpi_comm,&req.mpi_request());
+  return req;
+#else
+  return CommRequest();
+#endif
+}
+
+template<typename T>
+void Comm::gatherv (const T* my_vals, const int my_count, T* all_vals,
+                    const CommCounts& counts, const int root) const
+{
+  CommStatsTimer timer("gatherv",my_count*sizeof(T));
+#ifdef EKAT_ENABLE_MPI
+  check_mpi_inited();
+  auto mpi_type = get_mpi_type<T>();
+  if (m_rank==root) {
+    check_counts(counts);
+    MPI_Gatherv(my_vals,my_count,mpi_type,
+                all_vals,counts.counts.data(),counts.displs.data(),mpi_type,
+                root,m_mpi_comm);
+  } else {
+    MPI_Gatherv(my_vals,my_count,mpi_type,
+                nullptr,nullptr,nullptr,mpi_type,
+                root,m_mpi_comm);
+  }
+#else
+  check_counts(counts);
+  std::copy(my_vals, my_vals + my_count, all_vals + counts.displs[0]);
+#endif
+}
+
+template<typename T>
+void Comm::all_gatherv (const T* my_vals, const int my_count, T* all_vals,
+                        const CommCounts& counts) const
+{
+  check_counts(counts);
+  CommStatsTimer timer("all_gatherv",my_count*sizeof(T));
+#ifdef EKAT_ENABLE_MPI
+  check_mpi_inited();
+  auto mpi_type = get_mpi_type<T>();
+  MPI_Allgatherv(my_vals,my_count,mpi_type,
+                 all_vals,counts.counts.data(),counts.displs.data(),mpi_type,
+                 m_mpi_comm);
+#else
+  std::copy(my_vals, my_vals + my_count, all_vals + counts.displs[0]);
+#endif
+}
+
+template<typename T>
+void Comm::scatterv (const T* all_vals, const CommCounts& counts,
+                     T* my_vals, const int my_count, const int root) const
+{
+  CommStatsTimer timer("scatterv",my_count*sizeof(T));
+#ifdef EKAT_ENABLE_MPI
+  check_mpi_inited();
+  auto mpi_type = get_mpi_type<T>();
+  if (m_rank==root) {
+    check_counts(counts);
+    MPI_Scatterv(all_vals,counts.counts.data(),counts.displs.data(),mpi_type,
+                 my_vals,my_count,mpi_type,
+                 root,m_mpi_comm);
+  } else {
+    MPI_Scatterv(nullptr,nullptr,nullptr,mpi_type,
+                 my_vals,my_count,mpi_type,
+                 root,m_mpi_comm);
+  }
+#else
+  check_counts(counts);
+  std::copy(all_vals + counts.displs[0], all_vals + counts.displs[0] + my_count, my_vals);
+#endif
+}
+
+template<typename T>
+void Comm::all_to_allv (const T* send_vals, const CommCounts& send_counts,
+                        T* recv_vals, const CommCounts& recv_counts) const
+{
+  check_counts(send_counts);
+  check_counts(recv_counts);
+  CommStatsTimer timer("all_to_allv",send_counts.total()*sizeof(T));
+#ifdef EKAT_ENABLE_MPI
+  check_mpi_inited();
+  auto mpi_type = get_mpi_type<T>();
+  MPI_Alltoallv(send_vals,send_counts.counts.data(),send_counts.displs.data(),mpi_type,
+                recv_vals,recv_counts.counts.data(),recv_counts.displs.data(),mpi_type,
+                m_mpi_comm);
+#else
+  const T* beg = send_vals + send_counts.displs[0];
+  std::copy(beg, beg + send_counts.counts[0], recv_vals + recv_counts.displs[0]);
+#endif
+}
+
+template<typename T>
+void Comm::gatherv (T* all_vals, const CommCounts& counts, const int root) const
+{
+  check_counts(counts);
+  CommStatsTimer timer("gatherv",counts.counts[m_rank]*sizeof(T));
+#ifdef EKAT_ENABLE_MPI
+  check_mpi_inited();
+  auto mpi_type = get_mpi_type<T>();
+  if (m_rank==root) {
+    MPI_Gatherv(MPI_IN_PLACE,0,MPI_DATATYPE_NULL,
+                all_vals,counts.counts.data(),counts.displs.data(),mpi_type,
+                root,m_mpi_comm);
+  } else {
+    MPI_Gatherv(all_vals+counts.displs[m_rank],counts.counts[m_rank],mpi_type,
+                nullptr,nullptr,nullptr,mpi_type,
+                root,m_mpi_comm);
+  }
+#endif
+}
+
+template<typename T>
+void Comm::all_gatherv (T* all_vals, const CommCounts& counts) const
+{
+  check_counts(counts);
+  CommStatsTimer timer("all_gatherv",counts.counts[m_rank]*sizeof(T));
+#ifdef EKAT_ENABLE_MPI
+  check_mpi_inited();
+  auto mpi_type = get_mpi_type<T>();
+  MPI_Allgatherv(MPI_IN_PLACE,0,MPI_DATATYPE_NULL,
+                 all_vals,counts.counts.data(),counts.displs.data(),mpi_type,
+                 m_mpi_comm);
+#endif
+}
+
+template<typename T>
+void Comm::scatterv (T* all_vals, const CommCounts& counts, const int root) const
+{
+  check_counts(counts);
+  CommStatsTimer timer("scatterv",counts.counts[m_rank]*sizeof(T));
+#ifdef EKAT_ENABLE_MPI
+  check_mpi_inited();
+  auto mpi_type = get_mpi_type<T>();
+  if (m_rank==root) {
+    MPI_Scatterv(all_vals,counts.counts.data(),counts.displs.data(),mpi_type,
+                 MPI_IN_PLACE,0,MPI_DATATYPE_NULL,
+                 root,m_mpi_comm);
+  } else {
+    MPI_Scatterv(nullptr,nullptr,nullptr,mpi_type,
+                 all_vals+counts.displs[m_rank],counts.counts[m_rank],mpi_type,
+                 root,m_mpi_comm);
+  }
+#endif
+}
+
+template<typename T>
+void Comm::all_to_allv (T* vals, const CommCounts& counts) const
+{
+  check_counts(counts);
+  CommStatsTimer timer("all_to_allv",counts.total()*sizeof(T));
+#ifdef EKAT_ENABLE_MPI
+  check_mpi_inited();
+  auto mpi_type = get_mpi_type<T>();
+  MPI_Alltoallv(MPI_IN_PLACE,nullptr,nullptr,MPI_DATATYPE_NULL,
+                vals,counts.counts.data(),counts.displs.data(),mpi_type,
+                m_mpi_comm);
+#endif
+}
+
 } // namespace ekat
 
 #endif // EKAT_COMM_HPP
@@ -0,0 +1,219 @@
+#ifndef EKAT_COMM_KOKKOS_HPP
+#define EKAT_COMM_KOKKOS_HPP
+
+#include "ekat/mpi/ekat_comm.hpp"
+#include "ekat/ekat_pack.hpp"
+#include "ekat/ekat_assert.hpp"
+
+#include <Kokkos_Core.hpp>
+
+#include <limits>
+#include <type_traits>
+
+namespace ekat {
+
+// Packs are communicated as contiguous blocks of N scalars, and reduced entry-wise.
+template<typename T, int N>
+struct MpiTypeTraits<Pack<T,N>> {
+  using scalar_type = typename Pack<T,N>::scalar;
+  static constexpr int size = N;
+
+  static_assert (sizeof(Pack<T,N>)==N*sizeof(scalar_type),
+      "Error! Pack memory layout does not match an array of scalars.\n");
+
+  // The datatype is created once, and lives until MPI is finalized
+  static MPI_Datatype mpi_type () {
+#ifdef EKAT_ENABLE_MPI
+    static const MPI_Datatype type = [] () {
+      MPI_Datatype t;
+      MPI_Type_contiguous(N,get_mpi_type<scalar_type>(),&t);
+      MPI_Type_commit(&t);
+      return t;
+    }();
+    return type;
+#else
+    return get_mpi_type<scalar_type>();
+#endif
+  }
+};
+
+/*
+ * Collectives on Kokkos views.
+ *
+ * These are the analogues of the Comm methods with the same names, where the
+ * buffers (and their lengths) are given by the views. Views can have any rank,
+ * must be contiguous, and can store any type supported by Comm (including Packs,
+ * which are reduced entry-wise).
+ *
+ * If MPI can access the memory space of a view (always true for host views, and
+ * true for device views if EKAT_MPI_GPU_AWARE is defined), the view data is passed
+ * directly to MPI. Otherwise, the data is staged through host buffers.
+ * In both cases, the call fences the default execution space first, so that
+ * the content of the views is up to date.
+ */
+
+template<typename ViewT>
+void broadcast (const Comm& comm, const ViewT& v, const int root);
+
+template<typename SendViewT, typename RecvViewT>
+void all_reduce (const Comm& comm, const SendViewT& send, const RecvViewT& recv, const MPI_Op op);
+
+template<typename SendViewT, typename RecvViewT>
+void all_gather (const Comm& comm, const SendViewT& send, const RecvViewT& recv);
+
+// In place version of the above
+template<typename ViewT>
+void all_reduce (const Comm& comm, const ViewT& v, const MPI_Op op);
+
+// ================= IMPLEMENTATION ================= //
+
+namespace impl {
+
+// Whether MPI can read/write memory in the given memory space
+template<typename MemSpace>
+constexpr bool mpi_can_access () {
+#ifdef EKAT_MPI_GPU_AWARE
+  return true;
+#else
+  return Kokkos::SpaceAccessibility<Kokkos::HostSpace,MemSpace>::accessible;
+#endif
+}
+
+// The host buffer used to stage the data of a view
+template<typename ViewT>
+using MpiHostBuffer = Kokkos::View<typename ViewT::non_const_value_type*,Kokkos::HostSpace>;
+
+// A rank-1 view over the data of v
+template<typename ViewT>
+using MpiFlatView = Kokkos::View<typename ViewT::value_type*,typename ViewT::memory_space,Kokkos::MemoryUnmanaged>;
+
+template<typename ViewT>
+MpiFlatView<ViewT> mpi_flat_view (const ViewT& v, const char* name)
+{
+  EKAT_REQUIRE_MSG (v.span_is_contiguous(),
+      "Error! Views passed to " << name << " must be contiguous.\n"
+      "  - view label: " << v.label() << "\n");
+  EKAT_REQUIRE_MSG (v.size()<=static_cast<size_t>(std::numeric_limits<int>::max()),
+      "Error! View passed to " << name << " is too large for one MPI call.\n"
+      "  - view label: " << v.label() << "\n"
+      "  - view size : " << v.size() << "\n");
+  return MpiFlatView<ViewT>(v.data(),v.size());
+}
+
+// Pointer to data that MPI can read, equal to the content of v
+template<typename ViewT>
+const typename ViewT::non_const_value_type*
+mpi_send_data (const ViewT& v, MpiHostBuffer<ViewT>& host, const char* name)
+{
+  const auto flat = mpi_flat_view(v,name);
+  if (mpi_can_access<typename ViewT::memory_space>()) {
+    return flat.data();
+  }
+  host = MpiHostBuffer<ViewT>(Kokkos::view_alloc(Kokkos::WithoutInitializing,"mpi_send_buf"),flat.size());
+  Kokkos::deep_copy(host,flat);
+  return host.data();
+}
+
+// Pointer to memory that MPI can write, to be copied back in v (see mpi_recv_done)
+template<typename ViewT>
+typename ViewT::value_type*
+mpi_recv_data (const ViewT& v, MpiHostBuffer<ViewT>& host, const char* name)
+{
+  static_assert (not std::is_const<typename ViewT::value_type>::value,
+      "Error! Cannot receive data into a view of const values.\n");
+
+  const auto flat = mpi_flat_view(v,name);
+  if (mpi_can_access<typename ViewT::memory_space>()) {
+    return flat.data();
+  }
+  if (host.size()!=flat.size()) {
+    host = MpiHostBuffer<ViewT>(Kokkos::view_alloc(Kokkos::WithoutInitializing,"mpi_recv_buf"),flat.size());
+  }
+  return host.data();
+}
+
+// Copy the received data in v, if it was staged on host
+template<typename ViewT>
+void mpi_recv_done (const ViewT& v, const MpiHostBuffer<ViewT>& host)
+{
+  if (not mpi_can_access<typename ViewT::memory_space>()) {
+    Kokkos::deep_copy(mpi_flat_view(v,"mpi_recv_done"),host);
+  }
+}
+
+} // namespace impl
+
+template<typename ViewT>
+void broadcast (const Comm& comm, const ViewT& v, const int root)
+{
+  Kokkos::fence();
+
+  // The root sends the view content, and the other ranks overwrite it
+  impl::MpiHostBuffer<ViewT> host;
+  auto data = comm.rank()==root
+            ? const_cast<typename ViewT::value_type*>(impl::mpi_send_data(v,host,"broadcast"))
+            : impl::mpi_recv_data(v,host,"broadcast");
+  comm.broadcast(data,v.size(),root);
+  if (comm.rank()!=root) {
+    impl::mpi_recv_done(v,host);
+  }
+}
+
+template<typename SendViewT, typename RecvViewT>
+void all_reduce (const Comm& comm, const SendViewT& send, const RecvViewT& recv, const MPI_Op op)
+{
+  static_assert (std::is_same<typename SendViewT::non_const_value_type,
+                              typename RecvViewT::value_type>::value,
+      "Error! Send and recv views must store the same (non-const) value type.\n");
+  EKAT_REQUIRE_MSG (send.size()==recv.size(),
+      "Error! Send and recv views passed to all_reduce have different sizes.\n"
+      "  - send view: " << send.label() << ", size: " << send.size() << "\n"
+      "  - recv view: " << recv.label() << ", size: " << recv.size() << "\n");
+
+  Kokkos::fence();
+
+  impl::MpiHostBuffer<SendViewT> send_host;
+  impl::MpiHostBuffer<RecvViewT> recv_host;
+  comm.all_reduce(impl::mpi_send_data(send,send_host,"all_reduce"),
+                  impl::mpi_recv_data(recv,recv_host,"all_reduce"),
+                  send.size(),op);
+  impl::mpi_recv_done(recv,recv_host);
+}
+
+template<typename SendViewT, typename RecvViewT>
+void all_gather (const Comm& comm, const SendViewT& send, const RecvViewT& recv)
+{
+  static_assert (std::is_same<typename SendViewT::non_const_value_type,
+                              typename RecvViewT::value_type>::value,
+      "Error! Send and recv views must store the same (non-const) value type.\n");
+  EKAT_REQUIRE_MSG (recv.size()==send.size()*comm.size(),
+      "Error! Recv view passed to all_gather must be comm.size() times larger than the send view.\n"
+      "  - send view: " << send.label() << ", size: " << send.size() << "\n"
+      "  - recv view: " << recv.label() << ", size: " << recv.size() << "\n"
+      "  - comm size: " << comm.size() << "\n");
+
+  Kokkos::fence();
+
+  impl::MpiHostBuffer<SendViewT> send_host;
+  impl::MpiHostBuffer<RecvViewT> recv_host;
+  comm.all_gather(impl::mpi_send_data(send,send_host,"all_gather"),
+                  impl::mpi_recv_data(recv,recv_host,"all_gather"),
+                  send.size());
+  impl::mpi_recv_done(recv,recv_host);
+}
+
+template<typename ViewT>
+void all_reduce (const Comm& comm, const ViewT& v, const MPI_Op op)
+{
+  Kokkos::fence();
+
+  // If staging, the host buffer holds the input, and is overwritten with the result
+  impl::MpiHostBuffer<ViewT> host;
+  auto data = const_cast<typename ViewT::value_type*>(impl::mpi_send_data(v,host,"all_reduce"));
+  comm.all_reduce(data,v.size(),op);
+  impl::mpi_recv_done(v,host);
+}
+
+} // namespace ekat
+
+#endif // EKAT_COMM_KOKKOS_HPP
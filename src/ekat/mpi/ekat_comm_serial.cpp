@@ -9,6 +9,30 @@
 namespace ekat
 {
 
+// All operations complete immediately, so requests have nothing to wait for
+
+CommRequest::CommRequest (CommRequest&&)
+{
+}
+
+CommRequest& CommRequest::operator= (CommRequest&&)
+{
+  return *this;
+}
+
+void CommRequest::wait ()
+{
+}
+
+bool CommRequest::test ()
+{
+  return true;
+}
+
+void wait_all (std::vector<CommRequest>&)
+{
+}
+
 Comm::Comm()
   : m_mpi_comm(MPI_COMM_SELF), m_size(1), m_rank(0)
 {
@@ -23,12 +47,72 @@ void Comm::reset_mpi_comm (MPI_Comm new_mpi_comm)
 {
 }
 
+void Comm::set_collective_mode (const CollectiveMode mode)
+{
+  m_collective_mode = mode;
+}
+
 void Comm::barrier () const
 {
+  CommStatsTimer timer("barrier",0);
 }
 
 Comm Comm::split (const int color) const
 {
+  return split(color,m_rank);
+}
+
+Comm Comm::split (const int color, const int key) const
+{
+  CommStatsTimer timer("split",0);
+  return Comm(MPI_COMM_SELF);
+}
+
+Comm Comm::cached_split (const int color) const
+{
+  return split(color);
+}
+
+Comm Comm::cached_split (const int color, const int key) const
+{
+  return split(color,key);
+}
+
+void Comm::clear_split_cache ()
+{
+}
+
+bool Comm::owns_mpi_comm () const
+{
+  return false;
+}
+
+void Comm::own_mpi_comm ()
+{
+}
+
+CommCounts Comm::all_gather_counts (const int my_count) const
+{
+  CommStatsTimer timer("all_gather_counts",sizeof(int));
+  return CommCounts(std::vector<int>(1,my_count));
+}
+
+CommCounts Comm::all_to_all_counts (const CommCounts& send_counts) const
+{
+  check_counts(send_counts);
+  CommStatsTimer timer("all_to_all_counts",m_size*sizeof(int));
+  return CommCounts(send_counts.counts);
+}
+
+Comm Comm::split_shared () const
+{
+  CommStatsTimer timer("split_shared",0);
+  return Comm(MPI_COMM_SELF);
+}
+
+Comm Comm::split_node_leaders () const
+{
+  CommStatsTimer timer("split_node_leaders",0);
   return Comm(MPI_COMM_SELF);
 }
 
@@ -36,6 +120,16 @@ void Comm::check_mpi_inited () const
 {
 }
 
+void Comm::check_counts (const CommCounts& counts) const
+{
+  EKAT_REQUIRE_MSG (static_cast<int>(counts.counts.size())==m_size &&
+                    static_cast<int>(counts.displs.size())==m_size,
+      "Error! Counts and displacements must have one entry per rank.\n"
+      "  - comm size: " << m_size << "\n"
+      "  - num counts: " << counts.counts.size() << "\n"
+      "  - num displs: " << counts.displs.size() << "\n");
+}
+
 template<>
 MPI_Datatype get_mpi_type <char> () {
   return MPI_CHAR;
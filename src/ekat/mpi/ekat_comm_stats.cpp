@@ -0,0 +1,160 @@
+#include "ekat/mpi/ekat_comm_stats.hpp"
+#include "ekat/mpi/ekat_comm.hpp"
+
+#include <algorithm>
+#include <iomanip>
+#include <ostream>
+#include <set>
+#include <vector>
+
+namespace ekat {
+
+namespace {
+
+std::map<std::string,CommStatsEntry>& stats () {
+  static std::map<std::string,CommStatsEntry> s;
+  return s;
+}
+
+// The full labels of the currently open regions (innermost last)
+std::vector<std::string>& regions () {
+  static std::vector<std::string> r;
+  return r;
+}
+
+bool& timer_running () {
+  static bool running = false;
+  return running;
+}
+
+} // anonymous namespace
+
+void enable_comm_stats (const bool enable)
+{
+  comm_stats_enabled_flag() = enable;
+}
+
+const std::map<std::string,CommStatsEntry>& get_comm_stats ()
+{
+  return stats();
+}
+
+void reset_comm_stats ()
+{
+  stats().clear();
+}
+
+CommStatsRegion::CommStatsRegion (const std::string& label)
+{
+  auto& r = regions();
+  r.push_back(r.empty() ? label : r.back() + "/" + label);
+}
+
+CommStatsRegion::~CommStatsRegion ()
+{
+  regions().pop_back();
+}
+
+bool CommStatsTimer::start ()
+{
+  if (timer_running()) {
+    return false;
+  }
+  timer_running() = true;
+  return true;
+}
+
+void CommStatsTimer::stop (const char* name, const std::size_t bytes, const double seconds)
+{
+  timer_running() = false;
+
+  const auto& r = regions();
+  auto& e = stats()[r.empty() ? std::string(name) : r.back() + "/" + name];
+  ++e.count;
+  e.bytes += bytes;
+  e.seconds += seconds;
+}
+
+void print_comm_stats (const Comm& comm, std::ostream& out)
+{
+  // Do not record the collectives used to build the report
+  const bool enabled = comm_stats_enabled();
+  enable_comm_stats(false);
+
+  // Gather all the names (each one terminated by '\0'), and build their union,
+  // so that all ranks reduce the same entries, in the same order
+  std::string my_names;
+  for (const auto& it : stats()) {
+    my_names += it.first;
+    my_names += '\0';
+  }
+  const auto counts = comm.all_gather_counts(my_names.size());
+  std::vector<char> all_names(counts.total());
+  comm.all_gatherv(my_names.data(),my_names.size(),all_names.data(),counts);
+
+  std::set<std::string> names_set;
+  for (size_t pos=0; pos<all_names.size(); ) {
+    std::string name(all_names.data()+pos);
+    pos += name.size()+1;
+    names_set.insert(name);
+  }
+
+  // The last entry is the total over all collectives
+  std::vector<std::string> names(names_set.begin(),names_set.end());
+  names.push_back("total");
+  const int n = names.size();
+
+  std::vector<double> vals(3*n,0), mins(3*n), maxs(3*n), sums(3*n);
+  for (int i=0; i<n-1; ++i) {
+    auto it = stats().find(names[i]);
+    if (it!=stats().end()) {
+      vals[3*i]   = it->second.count;
+      vals[3*i+1] = it->second.bytes;
+      vals[3*i+2] = it->second.seconds;
+    }
+    for (int k=0; k<3; ++k) {
+      vals[3*(n-1)+k] += vals[3*i+k];
+    }
+  }
+  comm.all_reduce(vals.data(),mins.data(),3*n,MPI_MIN);
+  comm.all_reduce(vals.data(),maxs.data(),3*n,MPI_MAX);
+  comm.all_reduce(vals.data(),sums.data(),3*n,MPI_SUM);
+
+  if (comm.am_i_root()) {
+    const auto flags = out.flags();
+    const auto precision = out.precision();
+
+    size_t w = 5;
+    for (const auto& name : names) {
+      w = std::max(w,name.size());
+    }
+    const int size = comm.size();
+
+    out << "Comm stats on " << size << " ranks (avg calls and MB per rank, time in seconds):\n"
+        << "  " << std::left << std::setw(w) << "label" << std::right
+        << std::setw(12) << "calls" << std::setw(12) << "MB"
+        << std::setw(12) << "min time" << std::setw(12) << "avg time"
+        << std::setw(12) << "max time" << std::setw(10) << "max/avg" << "\n";
+    for (int i=0; i<n; ++i) {
+      const double avg_time = sums[3*i+2]/size;
+      out << "  " << std::left << std::setw(w) << names[i] << std::right
+          << std::fixed << std::setprecision(1)
+          << std::setw(12) << sums[3*i]/size
+          << std::setprecision(3)
+          << std::setw(12) << sums[3*i+1]/size/(1024*1024)
+          << std::setprecision(6)
+          << std::setw(12) << mins[3*i+2]
+          << std::setw(12) << avg_time
+          << std::setw(12) << maxs[3*i+2]
+          << std::setprecision(2)
+          << std::setw(10) << (avg_time>0 ? maxs[3*i+2]/avg_time : 1.0) << "\n";
+    }
+    out.flags(flags);
+    out.precision(precision);
+    out.flush();
+  }
+
+  enable_comm_stats(enabled);
+}
+
+} // namespace ekat
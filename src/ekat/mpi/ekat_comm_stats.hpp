@@ -0,0 +1,112 @@
+#ifndef EKAT_COMM_STATS_HPP
+#define EKAT_COMM_STATS_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <iosfwd>
+#include <map>
+#include <string>
+
+namespace ekat {
+
+class Comm;
+
+/*
+ * Opt-in instrumentation of the Comm collectives.
+ *
+ * When enabled, every Comm collective (including barrier, splits, and waits
+ * on nonblocking requests) records the number of calls, the bytes of this rank's
+ * buffers, and the wall time spent in the call. Entries are labeled by the
+ * collective name, prefixed by the labels of the enclosing CommStatsRegion's:
+ *
+ *   {
+ *     CommStatsRegion region("dyn");
+ *     comm.all_reduce(...);              // recorded as "dyn/all_reduce"
+ *   }
+ *   comm.barrier();                      // recorded as "barrier"
+ *
+ * The report (see print_comm_stats) shows min/avg/max across ranks of each
+ * entry, so that time spent waiting for other ranks (load imbalance) is visible.
+ * If enabled, the report is printed by finalize_ekat_session.
+ *
+ * Stats can be enabled with enable_comm_stats, or by setting the environment
+ * variable EKAT_COMM_STATS (to anything but 0) before initialize_ekat_session.
+ *
+ * NOTE: collectives called inside other collectives (e.g., in all_gather_counts)
+ *       are only recorded as part of the outer one.
+ * NOTE: for nonblocking collectives, the recorded time is the time to post the
+ *       operation, while the time to complete it is recorded as "wait".
+ * NOTE: stats are stored in global variables, and are not thread safe. Only one
+ *       thread per rank should call Comm methods while stats are enabled.
+ */
+
+struct CommStatsEntry {
+  long long count   = 0;
+  long long bytes   = 0;
+  double    seconds = 0;
+};
+
+void enable_comm_stats (const bool enable = true);
+
+inline bool& comm_stats_enabled_flag () {
+  static bool enabled = false;
+  return enabled;
+}
+inline bool comm_stats_enabled () { return comm_stats_enabled_flag(); }
+
+// The stats recorded on this rank, and a way to discard them
+const std::map<std::string,CommStatsEntry>& get_comm_stats ();
+void reset_comm_stats ();
+
+// Print min/avg/max across ranks of the recorded stats (on the comm root rank).
+// This is collective on comm: all ranks must call it, even if some of them did
+// not record all entries (the missing ones count as zero).
+void print_comm_stats (const Comm& comm, std::ostream& out);
+
+// Labels the collectives called during the lifetime of this object
+class CommStatsRegion {
+public:
+  explicit CommStatsRegion (const std::string& label);
+  ~CommStatsRegion ();
+
+  CommStatsRegion (const CommStatsRegion&) = delete;
+  CommStatsRegion& operator= (const CommStatsRegion&) = delete;
+};
+
+// Records one call of the given collective, timing the lifetime of this object.
+// This is used inside Comm, and costs one branch if stats are disabled.
+class CommStatsTimer {
+public:
+  CommStatsTimer (const char* name, const std::size_t bytes)
+  {
+    if (comm_stats_enabled() && start()) {
+      m_name = name;
+      m_bytes = bytes;
+      m_start = std::chrono::steady_clock::now();
+    }
+  }
+
+  ~CommStatsTimer ()
+  {
+    if (m_name!=nullptr) {
+      const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - m_start;
+      stop(m_name,m_bytes,elapsed.count());
+    }
+  }
+
+  CommStatsTimer (const CommStatsTimer&) = delete;
+  CommStatsTimer& operator= (const CommStatsTimer&) = delete;
+
+private:
+  // Return false if another timer is already running
+  static bool start ();
+  static void stop (const char* name, const std::size_t bytes, const double seconds);
+
+  const char* m_name = nullptr;
+  std::size_t m_bytes = 0;
+  std::chrono::steady_clock::time_point m_start;
+};
+
+} // namespace ekat
+
+#endif // EKAT_COMM_STATS_HPP
@@ -0,0 +1,361 @@
+#ifndef EKAT_HALO_EXCHANGE_HPP
+#define EKAT_HALO_EXCHANGE_HPP
+
+#include "ekat/mpi/ekat_comm.hpp"
+#include "ekat/kokkos/ekat_kokkos_types.hpp"
+#include "ekat/ekat_assert.hpp"
+
+#include <algorithm>
+#include <map>
+#include <vector>
+
+namespace ekat {
+
+/*
+ * A reusable halo exchange engine, built on top of Comm.
+ *
+ * Each rank registers its neighbors once, together with the local indices of
+ * the entries it sends to each neighbor, and the local indices where it stores
+ * the entries received from each neighbor. After setup, the exchange can be
+ * performed repeatedly on fields of shape (num_entries) or (num_entries,num_comps):
+ * entries are packed in a contiguous buffer (with a parallel kernel on DeviceT),
+ * exchanged with persistent MPI requests, and unpacked into the field.
+ *
+ * The communication pattern must be consistent across ranks: if rank A sends
+ * N entries to rank B, then B must register A as neighbor, and expect N entries
+ * from it. The i-th entry that A sends to B is stored at the i-th recv index
+ * that B registered for A. A rank can be its own neighbor (e.g., in periodic
+ * domains); in builds without MPI, that is the only possible neighbor.
+ *
+ * Usage:
+ *
+ *   HaloExchange<Real> halo(comm);
+ *   for (...) {
+ *     halo.add_neighbor(pid,send_lids,recv_lids);
+ *   }
+ *   halo.setup(num_comps);
+ *   while (...) {
+ *     halo.exchange(field);
+ *   }
+ *
+ * The exchange can also be split into start/finish calls, to overlap the
+ * communication with work that does not involve the halo entries. Since start
+ * packs the sent entries into the send buffers, these can be freely modified
+ * after start returns. However, the halo (recv) entries must not be read nor
+ * written until finish returns, since finish overwrites them.
+ *
+ * NOTE: if DeviceT's memory space is not accessible from host, MPI buffers
+ *       are staged on host, so MPI does not need to be GPU-aware.
+ * NOTE: if several exchanges are in progress on the same comm at the same
+ *       time, give each HaloExchange a different tag.
+ */
+
+template<typename ScalarT, typename DeviceT = DefaultDevice>
+class HaloExchange
+{
+public:
+  using KT          = KokkosTypes<DeviceT>;
+  using scalar_type = ScalarT;
+
+  template<typename T>
+  using view_1d = typename KT::template view_1d<T>;
+
+  HaloExchange (const Comm& comm, const int tag = 0);
+  ~HaloExchange ();
+
+  HaloExchange (const HaloExchange&) = delete;
+  HaloExchange& operator= (const HaloExchange&) = delete;
+
+  // Register a neighbor, along with the local indices of the entries to send to it,
+  // and the local indices where to store the entries received from it.
+  // Each neighbor can be registered only once, and only before setup is called.
+  void add_neighbor (const int pid,
+                     const std::vector<int>& send_lids,
+                     const std::vector<int>& recv_lids);
+
+  // Create index views, buffers, and persistent requests, for fields with
+  // the given number of components per entry.
+  void setup (const int num_comps = 1);
+
+  // Pack field and post sends/recvs
+  template<typename FieldView>
+  void start (const FieldView& field);
+
+  // Wait for the exchange to complete, and unpack into field
+  template<typename FieldView>
+  void finish (const FieldView& field);
+
+  template<typename FieldView>
+  void exchange (const FieldView& field) {
+    start(field);
+    finish(field);
+  }
+
+  const Comm& get_comm () const { return m_comm; }
+  int num_neighbors () const { return m_neighbors.size(); }
+  int num_comps () const { return m_num_comps; }
+  bool is_setup () const { return m_setup; }
+
+private:
+
+  template<typename FieldView>
+  void check_field (const FieldView& field) const;
+
+  template<typename FieldView>
+  KOKKOS_INLINE_FUNCTION
+  static typename std::enable_if<FieldView::Rank==1,typename FieldView::reference_type>::type
+  entry (const FieldView& f, const int i, const int /* comp */) { return f(i); }
+
+  template<typename FieldView>
+  KOKKOS_INLINE_FUNCTION
+  static typename std::enable_if<FieldView::Rank==2,typename FieldView::reference_type>::type
+  entry (const FieldView& f, const int i, const int comp) { return f(i,comp); }
+
+  using lids_type = view_1d<int>;
+  using buf_type  = view_1d<ScalarT>;
+
+  struct Neighbor {
+    std::vector<int> send_lids;
+    std::vector<int> recv_lids;
+  };
+
+  Comm      m_comm;
+  int       m_tag;
+  int       m_num_comps   = 0;
+  int       m_min_entries = 0;
+  bool      m_setup       = false;
+  bool      m_in_progress = false;
+
+  // Sorted by pid, so that the order of requests is the same on all ranks
+  std::map<int,Neighbor>  m_neighbors;
+
+  lids_type   m_send_lids;
+  lids_type   m_recv_lids;
+  buf_type    m_send_buf;
+  buf_type    m_recv_buf;
+  typename buf_type::HostMirror m_send_buf_h;
+  typename buf_type::HostMirror m_recv_buf_h;
+
+#ifdef EKAT_ENABLE_MPI
+  std::vector<MPI_Request>  m_requests;
+#endif
+};
+
+// ================= IMPLEMENTATION ================= //
+
+template<typename ScalarT, typename DeviceT>
+HaloExchange<ScalarT,DeviceT>::
+HaloExchange (const Comm& comm, const int tag)
+ : m_comm (comm)
+ , m_tag  (tag)
+{
+  // Nothing to do here
+}
+
+template<typename ScalarT, typename DeviceT>
+HaloExchange<ScalarT,DeviceT>::
+~HaloExchange ()
+{
+#ifdef EKAT_ENABLE_MPI
+  int finalized;
+  MPI_Finalized(&finalized);
+  if (finalized) {
+    return;
+  }
+  if (m_in_progress) {
+    MPI_Waitall(m_requests.size(),m_requests.data(),MPI_STATUSES_IGNORE);
+  }
+  for (auto& r : m_requests) {
+    MPI_Request_free(&r);
+  }
+#endif
+}
+
+template<typename ScalarT, typename DeviceT>
+void HaloExchange<ScalarT,DeviceT>::
+add_neighbor (const int pid,
+              const std::vector<int>& send_lids,
+              const std::vector<int>& recv_lids)
+{
+  EKAT_REQUIRE_MSG (not m_setup,
+      "Error! Cannot add neighbors to a HaloExchange after setup.\n");
+  EKAT_REQUIRE_MSG (pid>=0 && pid<m_comm.size(),
+      "Error! Invalid neighbor pid.\n"
+      "  - pid: " << pid << "\n"
+      "  - comm size: " << m_comm.size() << "\n");
+  EKAT_REQUIRE_MSG (m_neighbors.count(pid)==0,
+      "Error! Neighbor already registered in HaloExchange.\n"
+      "  - pid: " << pid << "\n");
+
+  for (auto lids : {&send_lids, &recv_lids}) {
+    for (auto lid : *lids) {
+      EKAT_REQUIRE_MSG (lid>=0,
+          "Error! Invalid local index for HaloExchange neighbor.\n"
+          "  - pid: " << pid << "\n"
+          "  - lid: " << lid << "\n");
+      m_min_entries = std::max(m_min_entries,lid+1);
+    }
+  }
+
+  auto& n = m_neighbors[pid];
+  n.send_lids = send_lids;
+  n.recv_lids = recv_lids;
+}
+
+template<typename ScalarT, typename DeviceT>
+void HaloExchange<ScalarT,DeviceT>::
+setup (const int num_comps)
+{
+  EKAT_REQUIRE_MSG (not m_setup,
+      "Error! HaloExchange::setup was already called.\n");
+  EKAT_REQUIRE_MSG (num_comps>0,
+      "Error! Invalid number of components for HaloExchange.\n"
+      "  - num comps: " << num_comps << "\n");
+
+  m_num_comps = num_comps;
+
+  // Concatenate the lids of all neighbors, and store offsets in the buffers
+  std::vector<int> send_offsets(1,0), recv_offsets(1,0);
+  for (const auto& it : m_neighbors) {
+    send_offsets.push_back(send_offsets.back()+it.second.send_lids.size());
+    recv_offsets.push_back(recv_offsets.back()+it.second.recv_lids.size());
+  }
+  m_send_lids = lids_type("HaloExchange::send_lids",send_offsets.back());
+  m_recv_lids = lids_type("HaloExchange::recv_lids",recv_offsets.back());
+  auto send_lids_h = Kokkos::create_mirror_view(m_send_lids);
+  auto recv_lids_h = Kokkos::create_mirror_view(m_recv_lids);
+  int k = 0;
+  for (const auto& it : m_neighbors) {
+    std::copy(it.second.send_lids.begin(),it.second.send_lids.end(),send_lids_h.data()+send_offsets[k]);
+    std::copy(it.second.recv_lids.begin(),it.second.recv_lids.end(),recv_lids_h.data()+recv_offsets[k]);
+    ++k;
+  }
+  Kokkos::deep_copy(m_send_lids,send_lids_h);
+  Kokkos::deep_copy(m_recv_lids,recv_lids_h);
+
+  m_send_buf = buf_type("HaloExchange::send_buf",send_offsets.back()*num_comps);
+  m_recv_buf = buf_type("HaloExchange::recv_buf",recv_offsets.back()*num_comps);
+  m_send_buf_h = Kokkos::create_mirror_view(m_send_buf);
+  m_recv_buf_h = Kokkos::create_mirror_view(m_recv_buf);
+
+#ifdef EKAT_ENABLE_MPI
+  // Create persistent requests (recvs first), so that each exchange only has to start them
+  const auto mpi_type = get_mpi_type<ScalarT>();
+  const auto mpi_comm = m_comm.mpi_comm();
+  m_requests.resize(2*m_neighbors.size());
+  k = 0;
+  for (const auto& it : m_neighbors) {
+    const int count = (recv_offsets[k+1]-recv_offsets[k])*num_comps;
+    MPI_Recv_init(m_recv_buf_h.data()+recv_offsets[k]*num_comps,count,mpi_type,
+                  it.first,m_tag,mpi_comm,&m_requests[k]);
+    ++k;
+  }
+  k = 0;
+  for (const auto& it : m_neighbors) {
+    const int count = (send_offsets[k+1]-send_offsets[k])*num_comps;
+    MPI_Send_init(m_send_buf_h.data()+send_offsets[k]*num_comps,count,mpi_type,
+                  it.first,m_tag,mpi_comm,&m_requests[m_neighbors.size()+k]);
+    ++k;
+  }
+#else
+  // Without MPI, we can only exchange with ourselves, which is a copy of the buffers
+  for (const auto& it : m_neighbors) {
+    EKAT_REQUIRE_MSG (it.second.send_lids.size()==it.second.recv_lids.size(),
+        "Error! Mismatch between number of sent and received entries in HaloExchange.\n"
+        "  - num sends: " << it.second.send_lids.size() << "\n"
+        "  - num recvs: " << it.second.recv_lids.size() << "\n");
+  }
+#endif
+
+  m_setup = true;
+}
+
+template<typename ScalarT, typename DeviceT>
+template<typename FieldView>
+void HaloExchange<ScalarT,DeviceT>::
+start (const FieldView& field)
+{
+  check_field(field);
+  EKAT_REQUIRE_MSG (not m_in_progress,
+      "Error! HaloExchange::start called while another exchange is in progress.\n");
+
+  using policy_t = typename KT::RangePolicy;
+
+  const auto lids = m_send_lids;
+  const auto buf  = m_send_buf;
+  const int  nc   = m_num_comps;
+  Kokkos::parallel_for("HaloExchange::pack",policy_t(0,lids.extent(0)*nc),
+                       KOKKOS_LAMBDA(const int idx) {
+    const int i = idx / nc;
+    const int c = idx % nc;
+    buf(idx) = entry(field,lids(i),c);
+  });
+
+#ifdef EKAT_ENABLE_MPI
+  Kokkos::deep_copy(m_send_buf_h,m_send_buf);
+  Kokkos::fence();
+  if (m_requests.size()>0) {
+    MPI_Startall(m_requests.size(),m_requests.data());
+  }
+#else
+  Kokkos::deep_copy(m_recv_buf,m_send_buf);
+#endif
+
+  m_in_progress = true;
+}
+
+template<typename ScalarT, typename DeviceT>
+template<typename FieldView>
+void HaloExchange<ScalarT,DeviceT>::
+finish (const FieldView& field)
+{
+  check_field(field);
+  EKAT_REQUIRE_MSG (m_in_progress,
+      "Error! HaloExchange::finish called without a matching call to start.\n");
+
+#ifdef EKAT_ENABLE_MPI
+  MPI_Waitall(m_requests.size(),m_requests.data(),MPI_STATUSES_IGNORE);
+  Kokkos::deep_copy(m_recv_buf,m_recv_buf_h);
+#endif
+  m_in_progress = false;
+
+  using policy_t = typename KT::RangePolicy;
+
+  const auto lids = m_recv_lids;
+  const auto buf  = m_recv_buf;
+  const int  nc   = m_num_comps;
+  Kokkos::parallel_for("HaloExchange::unpack",policy_t(0,lids.extent(0)*nc),
+                       KOKKOS_LAMBDA(const int idx) {
+    const int i = idx / nc;
+    const int c = idx % nc;
+    entry(field,lids(i),c) = buf(idx);
+  });
+}
+
+template<typename ScalarT, typename DeviceT>
+template<typename FieldView>
+void HaloExchange<ScalarT,DeviceT>::
+check_field (const FieldView& field) const
+{
+  static_assert (std::is_same<typename FieldView::non_const_value_type,ScalarT>::value,
+      "Error! HaloExchange field has the wrong scalar type.\n");
+  static_assert (std::is_same<typename FieldView::memory_space,typename KT::MemSpace>::value,
+      "Error! HaloExchange field must be in the memory space of the HaloExchange device.\n");
+  static_assert (FieldView::Rank==1 || FieldView::Rank==2,
+      "Error! HaloExchange only supports fields of rank 1 or 2.\n");
+
+  EKAT_REQUIRE_MSG (m_setup,
+      "Error! HaloExchange::setup must be called before exchanging fields.\n");
+  EKAT_REQUIRE_MSG (static_cast<int>(field.extent(0))>=m_min_entries,
+      "Error! HaloExchange field has fewer entries than the registered local indices require.\n"
+      "  - field extent: " << field.extent(0) << "\n"
+      "  - required extent: " << m_min_entries << "\n");
+  EKAT_REQUIRE_MSG ((FieldView::Rank==1 ? 1 : static_cast<int>(field.extent(1)))==m_num_comps,
+      "Error! HaloExchange field has the wrong number of components.\n"
+      "  - field comps: " << (FieldView::Rank==1 ? 1 : field.extent(1)) << "\n"
+      "  - expected comps: " << m_num_comps << "\n");
+}
+
+} // namespace ekat
+
+#endif // EKAT_HALO_EXCHANGE_HPP
@@ -0,0 +1,201 @@
+#include "ekat/mpi/ekat_reproducible_sum.hpp"
+#include "ekat/ekat_assert.hpp"
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+namespace ekat {
+
+namespace {
+
+constexpr std::int64_t limb_base = std::int64_t(1) << 32;
+constexpr std::int64_t limb_mask = limb_base - 1;
+constexpr int max_adds = 1 << 30;
+
+// Value of bit 0 of the fixed-point number is 2^min_exp
+constexpr int min_exp = -1074;
+
+// Indices of the inf/nan counters in the data array
+constexpr int pos_inf_idx = ReproducibleSum::num_limbs;
+constexpr int neg_inf_idx = ReproducibleSum::num_limbs+1;
+constexpr int nan_idx     = ReproducibleSum::num_limbs+2;
+
+} // anonymous namespace
+
+void ReproducibleSum::reset ()
+{
+  std::fill(m_data,m_data+data_size,0);
+  m_num_adds = 0;
+}
+
+void ReproducibleSum::add (const double x)
+{
+  std::uint64_t bits;
+  std::memcpy(&bits,&x,sizeof(double));
+
+  const bool neg = (bits >> 63)!=0;
+  const int  exp_bits = (bits >> 52) & 0x7ff;
+  std::uint64_t mant = bits & ((std::uint64_t(1) << 52) - 1);
+
+  if (exp_bits==0x7ff) {
+    ++m_data[mant!=0 ? nan_idx : (neg ? neg_inf_idx : pos_inf_idx)];
+    return;
+  }
+
+  // x = mant * 2^(min_exp + shift), with shift>=0
+  int shift = 0;
+  if (exp_bits>0) {
+    mant |= std::uint64_t(1) << 52;
+    shift = exp_bits - 1;
+  }
+  if (mant==0) {
+    return;
+  }
+
+  // The 53 bits of mant, shifted by b, span (at most) limbs i, i+1, i+2
+  const int i = shift / 32;
+  const int b = shift % 32;
+  const std::uint64_t lo = (mant & limb_mask) << b;
+  const std::uint64_t hi = ((mant >> 32) << b) + (lo >> 32);
+
+  const std::int64_t l0 = lo & limb_mask;
+  const std::int64_t l1 = hi & limb_mask;
+  const std::int64_t l2 = hi >> 32;
+  if (neg) {
+    m_data[i]   -= l0;
+    m_data[i+1] -= l1;
+    m_data[i+2] -= l2;
+  } else {
+    m_data[i]   += l0;
+    m_data[i+1] += l1;
+    m_data[i+2] += l2;
+  }
+
+  if (++m_num_adds==max_adds) {
+    normalize();
+  }
+}
+
+ReproducibleSum& ReproducibleSum::operator+= (const ReproducibleSum& rhs)
+{
+  // Limbs of normalized sums are less than 2^32, so this is safe from overflow
+  normalize();
+  ReproducibleSum tmp = rhs;
+  tmp.normalize();
+  for (int i=0; i<data_size; ++i) {
+    m_data[i] += tmp.m_data[i];
+  }
+  m_num_adds = 1;
+  return *this;
+}
+
+void ReproducibleSum::normalize ()
+{
+  for (int i=0; i<num_limbs-1; ++i) {
+    // Split the limb as carry*2^32 + r, with 0<=r<2^32 (also for negative limbs)
+    const std::int64_t r = m_data[i] & limb_mask;
+    m_data[i+1] += (m_data[i] - r) / limb_base;
+    m_data[i] = r;
+  }
+  m_num_adds = 0;
+}
+
+double ReproducibleSum::value () const
+{
+  constexpr double inf = std::numeric_limits<double>::infinity();
+  if (m_data[nan_idx]>0 || (m_data[pos_inf_idx]>0 && m_data[neg_inf_idx]>0)) {
+    return std::numeric_limits<double>::quiet_NaN();
+  } else if (m_data[pos_inf_idx]>0) {
+    return inf;
+  } else if (m_data[neg_inf_idx]>0) {
+    return -inf;
+  }
+
+  ReproducibleSum s = *this;
+  s.normalize();
+
+  // If the sum is negative, compute the value of its opposite
+  const bool neg = s.m_data[num_limbs-1]<0;
+  if (neg) {
+    for (int i=0; i<num_limbs; ++i) {
+      s.m_data[i] = -s.m_data[i];
+    }
+    s.normalize();
+  }
+
+  int k = num_limbs-1;
+  while (k>=0 && s.m_data[k]==0) {
+    --k;
+  }
+  if (k<0) {
+    return 0;
+  }
+  if (s.m_data[k]>=limb_base) {
+    // Only possible for the last limb, which is way above the largest double
+    return neg ? -inf : inf;
+  }
+
+  // Gather the 64 leading bits of the sum, and set the last one if any of the
+  // bits that are left out is nonzero (sticky bit). This way, the conversion
+  // to double rounds correctly, since 64 is more than the 53 bits of a double.
+  const std::uint64_t w2 = s.m_data[k];
+  const std::uint64_t w1 = k>=1 ? s.m_data[k-1] : 0;
+  const std::uint64_t w0 = k>=2 ? s.m_data[k-2] : 0;
+  int lead = 0;
+  while ((w2 >> lead)!=0) {
+    ++lead;
+  }
+  const int sh = 32 - lead;
+  std::uint64_t top = (w2 << (32+sh)) | (w1 << sh);
+  bool sticky;
+  if (sh>0) {
+    top |= w0 >> (32-sh);
+    sticky = (w0 & ((std::uint64_t(1) << (32-sh)) - 1))!=0;
+  } else {
+    sticky = w0!=0;
+  }
+  for (int i=0; i<k-2 && not sticky; ++i) {
+    sticky = s.m_data[i]!=0;
+  }
+  if (sticky) {
+    top |= 1;
+  }
+
+  // If the result is subnormal, then the sum is a multiple of 2^min_exp with
+  // less than 53 bits, so top is converted exactly, and ldexp does not round.
+  const double v = std::ldexp(static_cast<double>(top), min_exp + 32*(k-1) - sh);
+  return neg ? -v : v;
+}
+
+void reproducible_sum (const Comm& comm, ReproducibleSum* sums, const int count)
+{
+  // Summing limbs of normalized accumulators is exact, and integer sums are
+  // associative, so a plain MPI_SUM reduction gives the same result for any
+  // number of ranks. We must only make sure the limbs have enough headroom.
+  EKAT_REQUIRE_MSG (comm.size() < (1 << 30),
+      "Error! Too many ranks for reproducible_sum.\n");
+
+  constexpr int n = ReproducibleSum::data_size;
+  std::vector<std::int64_t> buf(count*n);
+  for (int i=0; i<count; ++i) {
+    sums[i].normalize();
+    std::copy(sums[i].data(),sums[i].data()+n,buf.data()+i*n);
+  }
+  comm.all_reduce(buf.data(),count*n,MPI_SUM);
+  for (int i=0; i<count; ++i) {
+    std::copy(buf.data()+i*n,buf.data()+(i+1)*n,sums[i].data());
+    sums[i].normalize();
+  }
+}
+
+double reproducible_sum (const Comm& comm, const double* vals, const int num_vals)
+{
+  ReproducibleSum sum;
+  sum.add(vals,num_vals);
+  reproducible_sum(comm,&sum,1);
+  return sum.value();
+}
+
+} // namespace ekat
@@ -0,0 +1,88 @@
+#ifndef EKAT_REPRODUCIBLE_SUM_HPP
+#define EKAT_REPRODUCIBLE_SUM_HPP
+
+#include "ekat/mpi/ekat_comm.hpp"
+
+#include <cstdint>
+
+namespace ekat {
+
+/*
+ * An exact accumulator for sums of doubles.
+ *
+ * Floating point addition is not associative, so the result of a sum depends
+ * on the order in which terms are added. In particular, a global sum computed
+ * with all_reduce(...,MPI_SUM) changes with the number of ranks.
+ *
+ * This class stores the sum as a fixed-point number, wide enough to represent
+ * any double exactly (from the smallest subnormal to the largest finite value).
+ * The fixed-point number is split in 32-bit limbs, each stored in a 64-bit
+ * integer, so that terms can be added without propagating carries right away.
+ * Since integer sums are associative, the result is exact, and independent of
+ * the order of the terms, or of how they are distributed across ranks.
+ * The final value is the correctly rounded (to nearest) exact sum.
+ *
+ * Infinities and NaNs are tracked separately, so that the sum is NaN if any
+ * term is NaN (or if both +inf and -inf are added), and +/-inf otherwise.
+ *
+ * For global sums, see the reproducible_sum functions below.
+ */
+
+class ReproducibleSum
+{
+public:
+  // The limb i holds bits [32*i,32*i+32) of the fixed-point number, whose
+  // bit 0 has value 2^-1074 (the smallest subnormal double). Limbs up to
+  // index 65 are needed to hold any double; the extra ones are headroom,
+  // for the carries of sums of very large terms.
+  static constexpr int num_limbs = 67;
+
+  // Number of integers in the data array: limbs, plus counters of +inf, -inf, and nan
+  static constexpr int data_size = num_limbs + 3;
+
+  ReproducibleSum () { reset(); }
+
+  void reset ();
+
+  void add (const double x);
+  void add (const double* x, const int n) {
+    for (int i=0; i<n; ++i) {
+      add(x[i]);
+    }
+  }
+
+  ReproducibleSum& operator+= (const double x) {
+    add(x);
+    return *this;
+  }
+  ReproducibleSum& operator+= (const ReproducibleSum& rhs);
+
+  // The correctly rounded value of the sum
+  double value () const;
+
+  // Propagate carries, so that all limbs but the last are in [0,2^32)
+  void normalize ();
+
+  // Raw access, for communication (see reproducible_sum)
+  const std::int64_t* data () const { return m_data; }
+        std::int64_t* data ()       { return m_data; }
+
+private:
+  std::int64_t  m_data[data_size];
+
+  // Number of additions since the last normalization. Each addition changes
+  // a limb by less than 2^32, so we can do 2^30 of them before normalizing.
+  int           m_num_adds;
+};
+
+// Sum the count accumulators (entry-wise) across all ranks. On output, all ranks
+// hold the same (normalized) accumulators.
+void reproducible_sum (const Comm& comm, ReproducibleSum* sums, const int count);
+
+// Reproducible version of a global sum, where each rank contributes num_vals
+// entries. The result is the same on all ranks, and for any number of ranks.
+double reproducible_sum (const Comm& comm, const double* vals, const int num_vals);
+
+} // namespace ekat
+
+#endif // EKAT_REPRODUCIBLE_SUM_HPP
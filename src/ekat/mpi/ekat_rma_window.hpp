@@ -0,0 +1,331 @@
+#ifndef EKAT_RMA_WINDOW_HPP
+#define EKAT_RMA_WINDOW_HPP
+
+#include "ekat/mpi/ekat_comm.hpp"
+#include "ekat/kokkos/ekat_kokkos_types.hpp"
+#include "ekat/ekat_assert.hpp"
+
+#include <type_traits>
+
+namespace ekat {
+
+/*
+ * A host array, distributed across the ranks of a comm, which other ranks can
+ * read (get) and update (accumulate) with one-sided (RMA) operations.
+ *
+ * Each rank exposes a local rank-1 host view, and entries are addressed by
+ * (target rank, offset in the target view). This is useful for sparse updates
+ * of arrays owned by other ranks, since the traffic is proportional to the
+ * number of updated entries, rather than to the number of ranks.
+ *
+ * RMA operations must happen inside an epoch. Two kinds are supported:
+ *  - active target: all ranks call fence (collective) before and after the ops;
+ *  - passive target: a rank calls lock_all, then issues ops, and calls flush
+ *    or flush_all to complete them, and finally unlock_all. The target ranks
+ *    can read the updates after a later synchronization (e.g., a fence).
+ * Typical usage:
+ *
+ *   RmaWindow<Real> win(comm,nlocal);
+ *   win.fence();
+ *   win.accumulate(pid,offsets,vals,n,MPI_SUM);
+ *   win.fence();
+ *   // read win.view()
+ *
+ * Local reads/writes of view() must not overlap with an epoch in which other
+ * ranks access this rank's entries.
+ *
+ * NOTE: constructor, destructor, and fence are collective on the input comm.
+ * NOTE: only builtin arithmetic types are supported, since MPI_Accumulate only
+ *       works with predefined ops, applied to predefined types.
+ * NOTE: without MPI, the only valid target rank is 0, and ops complete immediately.
+ *       Only MPI_SUM, MPI_PROD, MPI_MAX, MPI_MIN, and MPI_REPLACE are supported.
+ */
+
+template<typename ScalarT>
+class RmaWindow
+{
+  static_assert (std::is_arithmetic<ScalarT>::value,
+      "Error! RmaWindow only supports builtin arithmetic types.\n");
+
+public:
+  using view_type = Kokkos::View<ScalarT*,Kokkos::LayoutRight,HostDevice>;
+
+  // Allocate (and zero out) a local view of the given size
+  RmaWindow (const Comm& comm, const int local_size);
+
+  // Expose an existing (contiguous) host view
+  RmaWindow (const Comm& comm, const view_type& local_view);
+
+  ~RmaWindow ();
+
+  RmaWindow (const RmaWindow&) = delete;
+  RmaWindow& operator= (const RmaWindow&) = delete;
+
+  const view_type& view () const { return m_view; }
+  const Comm& get_comm () const { return m_comm; }
+
+  // Active target epochs
+  void fence () const;
+
+  // Passive target epochs
+  void lock_all ();
+  void unlock_all ();
+  void flush (const int target_rank) const;
+  void flush_all () const;
+
+  // Combine count values with the target entries [offset,offset+count)
+  void accumulate (const int target_rank, const int target_offset,
+                   const ScalarT* vals, const int count, const MPI_Op op) const;
+
+  // Combine vals[i] with the target entry offsets[i], for i in [0,count).
+  // The offsets must be distinct.
+  void accumulate (const int target_rank, const int* target_offsets,
+                   const ScalarT* vals, const int count, const MPI_Op op) const;
+
+  // Read the target entries [offset,offset+count)
+  void get (const int target_rank, const int target_offset,
+            ScalarT* result, const int count) const;
+
+  // Read the target entries offsets[i], for i in [0,count)
+  void get (const int target_rank, const int* target_offsets,
+            ScalarT* result, const int count) const;
+
+private:
+  void setup ();
+  void check_target (const int target_rank) const;
+
+  Comm        m_comm;
+  view_type   m_view;
+  bool        m_locked = false;
+
+#ifdef EKAT_ENABLE_MPI
+  MPI_Win     m_win;
+
+  // Datatype for the target entries at the given offsets (to be freed by the caller)
+  static MPI_Datatype indexed_type (const int* offsets, const int count);
+#else
+  static void apply (ScalarT& lhs, const ScalarT rhs, const MPI_Op op);
+#endif
+};
+
+// ================= IMPLEMENTATION ================= //
+
+template<typename ScalarT>
+RmaWindow<ScalarT>::
+RmaWindow (const Comm& comm, const int local_size)
+ : m_comm (comm)
+ , m_view ("RmaWindow",local_size)
+{
+  setup();
+}
+
+template<typename ScalarT>
+RmaWindow<ScalarT>::
+RmaWindow (const Comm& comm, const view_type& local_view)
+ : m_comm (comm)
+ , m_view (local_view)
+{
+  EKAT_REQUIRE_MSG (m_view.span_is_contiguous(),
+      "Error! RmaWindow requires a contiguous view.\n"
+      "  - view label: " << m_view.label() << "\n");
+  setup();
+}
+
+template<typename ScalarT>
+void RmaWindow<ScalarT>::setup ()
+{
+#ifdef EKAT_ENABLE_MPI
+  MPI_Win_create(m_view.data(),m_view.size()*sizeof(ScalarT),sizeof(ScalarT),
+                 MPI_INFO_NULL,m_comm.mpi_comm(),&m_win);
+#endif
+}
+
+template<typename ScalarT>
+RmaWindow<ScalarT>::
+~RmaWindow ()
+{
+#ifdef EKAT_ENABLE_MPI
+  int finalized;
+  MPI_Finalized(&finalized);
+  if (not finalized) {
+    if (m_locked) {
+      MPI_Win_unlock_all(m_win);
+    }
+    MPI_Win_free(&m_win);
+  }
+#endif
+}
+
+template<typename ScalarT>
+void RmaWindow<ScalarT>::fence () const
+{
+  CommStatsTimer timer("rma_fence",0);
+#ifdef EKAT_ENABLE_MPI
+  MPI_Win_fence(0,m_win);
+#endif
+}
+
+template<typename ScalarT>
+void RmaWindow<ScalarT>::lock_all ()
+{
+  EKAT_REQUIRE_MSG (not m_locked,
+      "Error! RmaWindow::lock_all called while already locked.\n");
+#ifdef EKAT_ENABLE_MPI
+  MPI_Win_lock_all(0,m_win);
+#endif
+  m_locked = true;
+}
+
+template<typename ScalarT>
+void RmaWindow<ScalarT>::unlock_all ()
+{
+  EKAT_REQUIRE_MSG (m_locked,
+      "Error! RmaWindow::unlock_all called without a matching lock_all.\n");
+  CommStatsTimer timer("rma_unlock_all",0);
+#ifdef EKAT_ENABLE_MPI
+  MPI_Win_unlock_all(m_win);
+#endif
+  m_locked = false;
+}
+
+template<typename ScalarT>
+void RmaWindow<ScalarT>::flush (const int target_rank) const
+{
+  EKAT_REQUIRE_MSG (m_locked,
+      "Error! RmaWindow::flush can only be called after lock_all.\n");
+  check_target(target_rank);
+  CommStatsTimer timer("rma_flush",0);
+#ifdef EKAT_ENABLE_MPI
+  MPI_Win_flush(target_rank,m_win);
+#endif
+}
+
+template<typename ScalarT>
+void RmaWindow<ScalarT>::flush_all () const
+{
+  EKAT_REQUIRE_MSG (m_locked,
+      "Error! RmaWindow::flush_all can only be called after lock_all.\n");
+  CommStatsTimer timer("rma_flush",0);
+#ifdef EKAT_ENABLE_MPI
+  MPI_Win_flush_all(m_win);
+#endif
+}
+
+template<typename ScalarT>
+void RmaWindow<ScalarT>::
+accumulate (const int target_rank, const int target_offset,
+            const ScalarT* vals, const int count, const MPI_Op op) const
+{
+  check_target(target_rank);
+  CommStatsTimer timer("rma_accumulate",count*sizeof(ScalarT));
+#ifdef EKAT_ENABLE_MPI
+  const auto mpi_type = get_mpi_type<ScalarT>();
+  MPI_Accumulate(vals,count,mpi_type,
+                 target_rank,target_offset,count,mpi_type,
+                 op,m_win);
+#else
+  for (int i=0; i<count; ++i) {
+    apply(m_view(target_offset+i),vals[i],op);
+  }
+#endif
+}
+
+template<typename ScalarT>
+void RmaWindow<ScalarT>::
+accumulate (const int target_rank, const int* target_offsets,
+            const ScalarT* vals, const int count, const MPI_Op op) const
+{
+  check_target(target_rank);
+  CommStatsTimer timer("rma_accumulate",count*sizeof(ScalarT));
+#ifdef EKAT_ENABLE_MPI
+  // MPI allows freeing the datatype before the operation completes
+  auto target_type = indexed_type(target_offsets,count);
+  MPI_Accumulate(vals,count,get_mpi_type<ScalarT>(),
+                 target_rank,0,1,target_type,
+                 op,m_win);
+  MPI_Type_free(&target_type);
+#else
+  for (int i=0; i<count; ++i) {
+    apply(m_view(target_offsets[i]),vals[i],op);
+  }
+#endif
+}
+
+template<typename ScalarT>
+void RmaWindow<ScalarT>::
+get (const int target_rank, const int target_offset,
+     ScalarT* result, const int count) const
+{
+  check_target(target_rank);
+  CommStatsTimer timer("rma_get",count*sizeof(ScalarT));
+#ifdef EKAT_ENABLE_MPI
+  const auto mpi_type = get_mpi_type<ScalarT>();
+  MPI_Get(result,count,mpi_type,
+          target_rank,target_offset,count,mpi_type,
+          m_win);
+#else
+  for (int i=0; i<count; ++i) {
+    result[i] = m_view(target_offset+i);
+  }
+#endif
+}
+
+template<typename ScalarT>
+void RmaWindow<ScalarT>::
+get (const int target_rank, const int* target_offsets,
+     ScalarT* result, const int count) const
+{
+  check_target(target_rank);
+  CommStatsTimer timer("rma_get",count*sizeof(ScalarT));
+#ifdef EKAT_ENABLE_MPI
+  auto target_type = indexed_type(target_offsets,count);
+  MPI_Get(result,count,get_mpi_type<ScalarT>(),
+          target_rank,0,1,target_type,
+          m_win);
+  MPI_Type_free(&target_type);
+#else
+  for (int i=0; i<count; ++i) {
+    result[i] = m_view(target_offsets[i]);
+  }
+#endif
+}
+
+template<typename ScalarT>
+void RmaWindow<ScalarT>::check_target (const int target_rank) const
+{
+  EKAT_REQUIRE_MSG (target_rank>=0 && target_rank<m_comm.size(),
+      "Error! Invalid target rank for RmaWindow operation.\n"
+      "  - target rank: " << target_rank << "\n"
+      "  - comm size: " << m_comm.size() << "\n");
+}
+
+#ifdef EKAT_ENABLE_MPI
+template<typename ScalarT>
+MPI_Datatype RmaWindow<ScalarT>::
+indexed_type (const int* offsets, const int count)
+{
+  MPI_Datatype t;
+  MPI_Type_create_indexed_block(count,1,offsets,get_mpi_type<ScalarT>(),&t);
+  MPI_Type_commit(&t);
+  return t;
+}
+#else
+template<typename ScalarT>
+void RmaWindow<ScalarT>::
+apply (ScalarT& lhs, const ScalarT rhs, const MPI_Op op)
+{
+  switch (op) {
+    case MPI_SUM:     lhs += rhs;                   break;
+    case MPI_PROD:    lhs *= rhs;                   break;
+    case MPI_MAX:     lhs = lhs<rhs ? rhs : lhs;    break;
+    case MPI_MIN:     lhs = rhs<lhs ? rhs : lhs;    break;
+    case MPI_REPLACE: lhs = rhs;                    break;
+    default:
+      EKAT_ERROR_MSG ("Error! Unsupported MPI_Op in serial RmaWindow.\n");
+  }
+}
+#endif
+
+} // namespace ekat
+
+#endif // EKAT_RMA_WINDOW_HPP
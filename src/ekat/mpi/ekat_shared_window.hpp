@@ -0,0 +1,155 @@
+#ifndef EKAT_SHARED_WINDOW_HPP
+#define EKAT_SHARED_WINDOW_HPP
+
+#include "ekat/mpi/ekat_comm.hpp"
+#include "ekat/kokkos/ekat_kokkos_types.hpp"
+#include "ekat/ekat_assert.hpp"
+
+#include <limits>
+
+namespace ekat {
+
+/*
+ * A host array shared by all the ranks on the same node.
+ *
+ * The memory is allocated (once per node) with MPI_Win_allocate_shared, on the
+ * comm obtained with Comm::split_shared, and is exposed as an unmanaged Kokkos
+ * host view. This is useful for large read-only data (e.g., lookup tables or
+ * grids), which can then be stored once per node, rather than once per rank.
+ *
+ * Typical usage:
+ *
+ *   SharedWindow<Real**> table(comm,nrows,ncols);
+ *   if (table.am_i_node_leader()) {
+ *     // fill table.view()
+ *   }
+ *   table.fence();
+ *   // read table.view()
+ *
+ * If the table is only available on the root rank of the input comm, use
+ * broadcast_from_root, which sends it to one rank per node, and fences.
+ *
+ * NOTE: constructor and destructor are collective on the input comm, and so
+ *       are fence and broadcast_from_root.
+ * NOTE: without MPI, the view is a regular host allocation.
+ */
+
+template<typename DataT>
+class SharedWindow
+{
+public:
+  using view_type  = Kokkos::View<DataT,Kokkos::LayoutRight,HostDevice,Kokkos::MemoryUnmanaged>;
+  using value_type = typename view_type::value_type;
+
+  template<typename... Dims>
+  SharedWindow (const Comm& comm, const Dims... dims);
+  ~SharedWindow ();
+
+  SharedWindow (const SharedWindow&) = delete;
+  SharedWindow& operator= (const SharedWindow&) = delete;
+
+  const view_type& view () const { return m_view; }
+
+  const Comm& get_node_comm () const { return m_node_comm; }
+  bool am_i_node_leader () const { return m_node_comm.am_i_root(); }
+
+  // Synchronize the node ranks, so that writes performed before the
+  // fence are visible to all of them after the fence.
+  void fence () const;
+
+  // Copy the content of the root rank view to all nodes (and fence)
+  void broadcast_from_root ();
+
+private:
+  Comm        m_node_comm;
+  Comm        m_leaders_comm;   // Only used on node leaders
+  view_type   m_view;
+
+#ifdef EKAT_ENABLE_MPI
+  MPI_Win     m_win;
+#else
+  Kokkos::View<DataT,Kokkos::LayoutRight,HostDevice> m_storage;
+#endif
+};
+
+// ================= IMPLEMENTATION ================= //
+
+template<typename DataT>
+template<typename... Dims>
+SharedWindow<DataT>::
+SharedWindow (const Comm& comm, const Dims... dims)
+ : m_node_comm (comm.split_shared())
+ , m_leaders_comm (comm.split_node_leaders())
+{
+  m_node_comm.own_mpi_comm();
+  m_leaders_comm.own_mpi_comm();
+
+#ifdef EKAT_ENABLE_MPI
+  // Only the node leader allocates memory, and the others get a pointer to it
+  const size_t bytes = view_type::required_allocation_size(dims...);
+  void* base;
+  MPI_Win_allocate_shared(am_i_node_leader() ? bytes : 0, sizeof(value_type),
+                          MPI_INFO_NULL, m_node_comm.mpi_comm(), &base, &m_win);
+
+  MPI_Aint size;
+  int disp_unit;
+  MPI_Win_shared_query(m_win, 0, &size, &disp_unit, &base);
+  EKAT_REQUIRE_MSG (static_cast<size_t>(size)>=bytes,
+      "Error! Shared window is smaller than requested.\n"
+      "  - requested bytes: " << bytes << "\n"
+      "  - window bytes: " << size << "\n");
+
+  m_view = view_type(static_cast<value_type*>(base),dims...);
+
+  // Open a passive target epoch for the lifetime of the window,
+  // so that fence only needs to sync memory and ranks
+  MPI_Win_lock_all(MPI_MODE_NOCHECK,m_win);
+#else
+  m_storage = decltype(m_storage)("SharedWindow",dims...);
+  m_view = view_type(m_storage.data(),dims...);
+#endif
+}
+
+template<typename DataT>
+SharedWindow<DataT>::
+~SharedWindow ()
+{
+#ifdef EKAT_ENABLE_MPI
+  int finalized;
+  MPI_Finalized(&finalized);
+  if (not finalized) {
+    MPI_Win_unlock_all(m_win);
+    MPI_Win_free(&m_win);
+  }
+#endif
+}
+
+template<typename DataT>
+void SharedWindow<DataT>::fence () const
+{
+#ifdef EKAT_ENABLE_MPI
+  MPI_Win_sync(m_win);
+  m_node_comm.barrier();
+  MPI_Win_sync(m_win);
+#endif
+}
+
+template<typename DataT>
+void SharedWindow<DataT>::broadcast_from_root ()
+{
+#ifdef EKAT_ENABLE_MPI
+  EKAT_REQUIRE_MSG (m_view.size()<=static_cast<size_t>(std::numeric_limits<int>::max()),
+      "Error! SharedWindow is too large to be broadcast in one call.\n");
+
+  // Only node leaders take part in the broadcast. Since ranks keep their order
+  // in the splits, the root is the leader of its node, and rank 0 among the leaders.
+  if (am_i_node_leader()) {
+    m_leaders_comm.broadcast(m_view.data(),m_view.size(),m_leaders_comm.root_rank());
+  }
+#endif
+  fence();
+}
+
+} // namespace ekat
+
+#endif // EKAT_SHARED_WINDOW_HPP
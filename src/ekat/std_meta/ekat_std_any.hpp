@@ -14,14 +14,27 @@
 #include "ekat/std_meta/ekat_std_utils.hpp"
 #include "ekat/ekat_type_traits.hpp"
 
+#include <cstddef>
 #include <memory>
 #include <iostream>
+#include <new>
 #include <typeindex>
+#include <type_traits>
 
 namespace ekat {
 
 // ================ std::any ================= //
 
+/*
+ * Small, trivially copyable types (e.g., int, double, small POD structs)
+ * are stored in an internal buffer: no heap allocation is performed, and
+ * copying an any copies the value. All other types are stored in a
+ * heap-allocated holder via shared_ptr, so that copies of an any share
+ * the same object (and its type need not be copyable).
+ * A value in the internal buffer is moved to the heap the first time
+ * any_ptr_cast is called on it, so that the returned pointer owns it.
+ */
+
 class any {
 
   // Implementation detail of the any class
@@ -32,16 +45,37 @@ class any {
     virtual const std::type_info& type () const = 0;
 
     virtual void print (std::ostream& os) const = 0;
+
+    // The address of the stored object
+    virtual void* value_ptr () = 0;
+
+    // Copy-construct this holder in the input buffer (small holders only)
+    virtual holder_base* copy_to (void* buf) const = 0;
   };
 
+  template<typename T>
+  static typename std::enable_if<!StreamExists<T>::value>::type
+  print_value (std::ostream& os, const T&) {
+    os << "Error! Trying to print object of type '" << typeid(T).name() << "',"
+       << "       which does not overload operator<< .\n";
+  }
+
+  template<typename T>
+  static typename std::enable_if<StreamExists<T>::value>::type
+  print_value (std::ostream& os, const T& t) {
+    os << t;
+  }
+
   template <typename HeldType>
   class holder : public holder_base {
   public:
 
     template<typename... Args>
-    static holder<HeldType>* create(const Args&... args) {
+    static
+    typename std::enable_if<std::is_constructible<HeldType,Args&&...>::value,holder<HeldType>*>::type
+    create(Args&&... args) {
       holder* ptr = new holder<HeldType>();
-      ptr->m_value = std::make_shared<HeldType>(args...);
+      ptr->m_value = std::make_shared<HeldType>(std::forward<Args>(args)...);
       return ptr;
     }
 
@@ -60,28 +94,21 @@ class any {
     HeldType& value () { return *m_value; }
     std::shared_ptr<HeldType> ptr () const { return m_value; }
 
+    void* value_ptr () { return m_value.get(); }
+
+    holder_base* copy_to (void*) const {
+      EKAT_ERROR_MSG ("Error! Heap-allocated holders are shared, not copied.\n");
+      return nullptr;
+    }
+
     void print (std::ostream& os) const {
       if (static_cast<bool>(m_value)) {
-        print_impl<HeldType>(os);
+        print_value(os,*m_value);
       }
     }
   private:
     holder () = default;
 
-    template<typename T>
-    typename std::enable_if<!StreamExists<T>::value>::type
-    print_impl (std::ostream& os) const {
-
-      os << "Error! Trying to print object of type '" << type().name() << "',"
-         << "       which does not overload operator<< .\n";
-    }
-
-    template<typename T>
-    typename std::enable_if<StreamExists<T>::value>::type
-    print_impl (std::ostream& os) const {
-      os << *m_value;
-    }
-
     // Note: we store a shared_ptr rather than a HeldType directly,
     //       since we may store multiple copies of the concrete object.
     //       Since we don't know if the actual object is copiable, we need
@@ -89,6 +116,37 @@ class any {
     std::shared_ptr<HeldType> m_value;
   };
 
+  template <typename HeldType>
+  class small_holder : public holder_base {
+  public:
+    template<typename... Args>
+    small_holder (Args&&... args) : m_value(std::forward<Args>(args)...) {}
+
+    const std::type_info& type () const { return typeid(HeldType); }
+
+    void* value_ptr () { return &m_value; }
+
+    holder_base* copy_to (void* buf) const {
+      return new (buf) small_holder<HeldType>(*this);
+    }
+
+    void print (std::ostream& os) const { print_value(os,m_value); }
+  private:
+    HeldType m_value;
+  };
+
+  // Room for a small_holder's vtable pointer plus a 32 bytes object
+  static constexpr size_t small_buffer_size = 32 + sizeof(void*);
+
+  template<typename T, typename... Args>
+  struct use_small_buffer {
+    static constexpr bool value =
+      std::is_trivially_copyable<T>::value &&
+      std::is_constructible<T,Args&&...>::value &&
+      sizeof(small_holder<T>) <= small_buffer_size &&
+      alignof(small_holder<T>) <= alignof(std::max_align_t);
+  };
+
 public:
 
   any () = default;
@@ -97,23 +155,68 @@ public:
     reset (t);
   }
 
+  any (const any& src)
+   : m_content (src.m_content)
+  {
+    if (src.m_small) {
+      m_small = src.m_small->copy_to(&m_buffer);
+    }
+  }
+
+  any (any&& src) noexcept
+   : m_content (std::move(src.m_content))
+  {
+    // Small types are trivially copyable, so a copy is as good as a move
+    if (src.m_small) {
+      m_small = src.m_small->copy_to(&m_buffer);
+      src.clear();
+    }
+  }
+
+  ~any () { clear(); }
+
+  any& operator= (const any& src) {
+    if (this!=&src) {
+      clear();
+      m_content = src.m_content;
+      if (src.m_small) {
+        m_small = src.m_small->copy_to(&m_buffer);
+      }
+    }
+    return *this;
+  }
+
+  any& operator= (any&& src) noexcept {
+    if (this!=&src) {
+      clear();
+      m_content = std::move(src.m_content);
+      if (src.m_small) {
+        m_small = src.m_small->copy_to(&m_buffer);
+        src.clear();
+      }
+    }
+    return *this;
+  }
+
   template<typename T, typename... Args>
-  void reset (Args... args) {
-    m_content.reset( holder<T>::create(args...) );
+  void reset (Args&&... args) {
+    clear();
+    emplace<T>(std::integral_constant<bool,use_small_buffer<T,Args...>::value>(),
+               std::forward<Args>(args)...);
   }
 
   template<typename T>
   void reset (const T& t) {
-    m_content.reset( holder<T>::create(t) );
+    reset<T,const T&>(t);
   }
 
   holder_base& content () const { 
-    EKAT_REQUIRE_MSG (static_cast<bool>(m_content), "Error! Object not yet initialized.\n");
-    return *m_content;
+    EKAT_REQUIRE_MSG (content_ptr()!=nullptr, "Error! Object not yet initialized.\n");
+    return *content_ptr();
   }
 
   holder_base* content_ptr () const { 
-    return m_content.get();
+    return m_small ? m_small : m_content.get();
   }
 
   template<typename ConcreteType>
@@ -132,7 +235,41 @@ public:
   
 private:
 
+  template<typename T, typename... Args>
+  void emplace (std::true_type /* small */, Args&&... args) {
+    m_small = new (&m_buffer) small_holder<T>(std::forward<Args>(args)...);
+  }
+
+  template<typename T, typename... Args>
+  void emplace (std::false_type /* small */, Args&&... args) {
+    m_content.reset( holder<T>::create(std::forward<Args>(args)...) );
+  }
+
+  // Move a value stored in the small buffer to a (shared) heap holder
+  template<typename T>
+  void move_to_heap () {
+    if (m_small) {
+      holder_base* h = holder<T>::create(*static_cast<const T*>(m_small->value_ptr()));
+      clear();
+      m_content.reset(h);
+    }
+  }
+
+  void clear () {
+    if (m_small) {
+      m_small->~holder_base();
+      m_small = nullptr;
+    }
+    m_content.reset();
+  }
+
+  // Used for large/non-trivially copyable types
   std::shared_ptr<holder_base> m_content;
+
+  // Used for small, trivially copyable types. If not null, m_small
+  // points to the small_holder constructed in m_buffer.
+  holder_base* m_small = nullptr;
+  typename std::aligned_storage<small_buffer_size,alignof(std::max_align_t)>::type m_buffer;
 };
 
 template<typename ConcreteType>
@@ -143,13 +280,8 @@ ConcreteType& any_cast (any& src) {
       "   - actual type:    " + std::string(src.content().type().name()) + "\n"
       "   - requested type: " + std::string(typeid(ConcreteType).name()) + "'.\n");
 
-  any::holder<ConcreteType>* ptr = dynamic_cast<any::holder<ConcreteType>*>(src.content_ptr());
-
-  EKAT_REQUIRE_MSG(ptr!=nullptr,
-      "Error! Failed dynamic_cast during any_cast.\n"
-      "       This is an internal problem, please, contact developers.\n");
-
-  return ptr->value();
+  // The type was checked above, so no need for a dynamic_cast
+  return *static_cast<ConcreteType*>(src.content().value_ptr());
 }
 
 template<typename ConcreteType>
@@ -159,15 +291,13 @@ const ConcreteType& any_cast (const any& src) {
       "   - actual type:    " + std::string(src.content().type().name()) + "\n"
       "   - requested type: " + std::string(typeid(ConcreteType).name()) + "'.\n");
 
-  any::holder<ConcreteType>* ptr = dynamic_cast<any::holder<ConcreteType>*>(src.content_ptr());
-
-  EKAT_REQUIRE_MSG(ptr!=nullptr,
-      "Error! Failed dynamic_cast during any_cast.\n"
-      "       This is an internal problem, please, contact developers.\n");
-
-  return ptr->value();
+  // The type was checked above, so no need for a dynamic_cast
+  return *static_cast<const ConcreteType*>(src.content().value_ptr());
 }
 
+// Note: a value stored in the small buffer is first moved to the heap, so that
+//       the returned pointer shares ownership of it. From then on, copies of
+//       src share the value too.
 template<typename ConcreteType>
 std::shared_ptr<ConcreteType> any_ptr_cast (any& src) {
   EKAT_REQUIRE_MSG(src.isType<ConcreteType>(),
@@ -175,6 +305,8 @@ std::shared_ptr<ConcreteType> any_ptr_cast (any& src) {
       "   - actual type:    " + std::string(src.content().type().name()) + "\n"
       "   - requested type: " + std::string(typeid(ConcreteType).name()) + "'.\n");
 
+  src.move_to_heap<ConcreteType>();
+
   any::holder<ConcreteType>* ptr = dynamic_cast<any::holder<ConcreteType>*>(src.content_ptr());
 
   EKAT_REQUIRE_MSG(ptr!=nullptr,
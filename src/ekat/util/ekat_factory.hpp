@@ -3,14 +3,43 @@
 
 #include "ekat/ekat_assert.hpp"
 #include "ekat/ekat_type_traits.hpp"
+#include "ekat/util/ekat_suggestion_index.hpp"
 
-#include <string>
-#include <sstream>
+#include <algorithm>
+#include <atomic>
 #include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 namespace ekat
 {
 
+/*
+ * A generic factory, storing creators for concrete products, keyed by
+ * a label.
+ *
+ * Readers (create, has_product, ...) never lock: they perform a single atomic
+ * load of a pointer to the registry, followed by a (hashed) lookup.
+ * Writers (register_product) are serialized. By default, a registration
+ * modifies the registry in place, so registering while other threads read
+ * from the factory is not safe.
+ *
+ * Calling enable_concurrent_access switches to a read-mostly concurrent mode:
+ * each registration publishes a modified copy of the registry, which is never
+ * modified once published, so products can be registered while other threads
+ * are creating products. Since readers may still be using them, replaced
+ * registries are only released by clean_up. Hence, register most products
+ * before enabling this mode: registering N products afterwards costs O(N^2)
+ * time and memory.
+ *
+ * If std::hash is available for KeyType, the registry is a hash map,
+ * otherwise it is an ordered map.
+ */
+
 template<typename AbstractProduct,
          typename KeyType,
          typename PointerType,
@@ -24,7 +53,9 @@ public:
   using obj_type      = AbstractProduct;
   using obj_ptr_type  = PointerType;
   using creator_type  = obj_ptr_type (*) (const ConstructorArgs... args);
-  using register_type = std::map<key_type,creator_type>;
+  using register_type = typename std::conditional<HashExists<key_type>::value,
+                                                  std::unordered_map<key_type,creator_type>,
+                                                  std::map<key_type,creator_type>>::type;
 
   // Make sure that obj_ptr_type is indeed some sort of pointer to obj_type
   using deref_pointer_type = typename std::remove_reference<decltype(*std::declval<PointerType>())>::type;
@@ -34,18 +65,18 @@ public:
   static factory_type& instance ()
   {
     static factory_type factory;
-
-    // We rely on whatever the implementation can give us
-    factory.m_factory_name = typeid(factory_type).name();
-
     return factory;
   }
 
   // For debugging, inspect if the size of the register in the factory
-  size_t register_size () const { return m_register.size(); }
+  size_t register_size () const { return current()->size(); }
 
   // Return the name of the factory
-  static const std::string& name () { return m_factory_name; }
+  static const std::string& name () {
+    // We rely on whatever the implementation can give us
+    static const std::string factory_name = typeid(factory_type).name();
+    return factory_name;
+  }
 
   // Register a creator and returns true if it was successfully registered
   bool register_product (const key_type& key,
@@ -53,51 +84,90 @@ public:
                          const bool replace_if_found = false);
 
   // Creates a concrete object using the proper creator
-  obj_ptr_type create (const key_type& label, ConstructorArgs&& ...args);
+  obj_ptr_type create (const key_type& label, ConstructorArgs&& ...args) const;
 
   bool has_product (const key_type& key) const {
-    return m_register.find(key)!=m_register.end();
+    const auto reg = current();
+    return reg->find(key)!=reg->end();
+  }
+
+  // Allow registering products while other threads read from the factory
+  void enable_concurrent_access () {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_concurrent = true;
   }
 
   // Cleans up the factory
   // This can be useful during unit tests, where several tests in the same
   // execution will try to register the same product(s).
-  void clean_up () { m_register.clear(); }
+  // Note: this is NOT thread safe, since it releases all the registries
+  //       replaced in concurrent mode. No other thread must be using the factory.
+  void clean_up ();
 
 private:
-  std::string print_registered_products () const {
-    return print_registered_products_impl<StreamExists<key_type>::value>();
+  std::string print_registered_products (const register_type& reg) const {
+    return print_registered_products_impl<StreamExists<key_type>::value>(reg);
   }
 
   template<int OpStreamExists>
   typename std::enable_if<OpStreamExists==1,std::string>::type
-  print_registered_products_impl () const;
+  print_registered_products_impl (const register_type& reg) const;
 
   template<int OpStreamExists>
   typename std::enable_if<OpStreamExists==0,std::string>::type
-  print_registered_products_impl () const {
+  print_registered_products_impl (const register_type&) const {
     // We cannot use << to print out the keys in this factory, so we just print a message.
-    return " Warning! Cannot print registered products in factory " + m_factory_name + ".\n"
+    return " Warning! Cannot print registered products in factory " + name() + ".\n"
            "          The type " + std::string(typeid(key_type).name()) + " does not overload the '<<' operator.\n"
            "          We have no idea how to print the registered products, so we just print this message. Sorry.\n";
   }
 
-  Factory () = default;
+  // Suggest registered keys similar to a key that was not found
+  std::string suggest_products (const std::string& key) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const auto s = m_index.did_you_mean(key);
+    return s.empty() ? s : "        " + s + "\n";
+  }
+  template<typename K>
+  std::string suggest_products (const K&) const {
+    // We only know how to compare strings
+    return "";
+  }
+
+  // Add a registered key to the suggestions index
+  void index_product (const std::string& key) { m_index.add(key); }
+  template<typename K>
+  void index_product (const K&) {}
+
+  // The current registry
+  const register_type* current () const {
+    return m_register.load(std::memory_order_acquire);
+  }
+
+  // Make reg the current registry, keeping the old one alive until clean_up.
+  // Must be called while holding m_mutex.
+  void publish (std::unique_ptr<register_type> reg) {
+    m_register.store(reg.get(),std::memory_order_release);
+    if (m_owned) {
+      m_retired.push_back(std::move(m_owned));
+    }
+    m_owned = std::move(reg);
+  }
+
+  Factory () { publish(std::unique_ptr<register_type>(new register_type())); }
   Factory (const factory_type&) = delete;
   factory_type& operator= (const factory_type&) = delete;
   Factory (factory_type&&) = delete;
   factory_type& operator= (factory_type&&) = delete;
 
-  register_type         m_register;
-  static std::string    m_factory_name;
+  std::atomic<const register_type*>             m_register;
+  std::unique_ptr<register_type>                m_owned;    // The current registry
+  std::vector<std::unique_ptr<register_type>>   m_retired;  // Replaced in concurrent mode
+  bool                                          m_concurrent = false;
+  SuggestionIndex                               m_index;    // All registered keys
+  mutable std::mutex                            m_mutex;
 };
 
-template<typename AbstractProduct,
-         typename KeyType,
-         typename PointerType,
-         typename... ConstructorArgs>
-std::string Factory<AbstractProduct,KeyType,PointerType,ConstructorArgs...>::m_factory_name;
-
 // ========================== IMPLEMENTATION ======================== //
 
 template<typename AbstractProduct,
@@ -109,39 +179,65 @@ register_product (const key_type& key,
                   const creator_type& creator,
                   const bool replace_if_found)
 {
-  auto it = m_register.find(key);
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  auto it = m_owned->find(key);
 
-  if (it==m_register.end() || replace_if_found )
+  if (it==m_owned->end() || replace_if_found )
   {
-    m_register[key] = creator;
+    index_product(key);
+    if (m_concurrent) {
+      std::unique_ptr<register_type> reg(new register_type(*m_owned));
+      (*reg)[key] = creator;
+      publish(std::move(reg));
+    } else {
+      (*m_owned)[key] = creator;
+    }
     return true;
   }
   return false;
 }
 
+template<typename AbstractProduct,
+         typename KeyType,
+         typename PointerType,
+         typename... ConstructorArgs>
+void Factory<AbstractProduct,KeyType,PointerType,ConstructorArgs...>::
+clean_up ()
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  publish(std::unique_ptr<register_type>(new register_type()));
+  m_retired.clear();
+  m_index = SuggestionIndex();
+}
+
 template<typename AbstractProduct,
          typename KeyType,
          typename PointerType,
          typename... ConstructorArgs>
 PointerType Factory<AbstractProduct,KeyType,PointerType,ConstructorArgs...>::
-create (const key_type& key,ConstructorArgs&& ...args)
+create (const key_type& key,ConstructorArgs&& ...args) const
 {
+  const auto& reg = *current();
+
   // Check that the factory is not empty.
   // Note: this check is redundant, since, if negative, the next one would fail too.
   //       However, this check is symptomatic of a larger problem (not registering product)
   //       than simply not finding the requested one (perhaps because of spelling).
-  EKAT_REQUIRE_MSG(m_register.size()>0,
-                     "[" + m_factory_name + "] Error!\n"
+  EKAT_REQUIRE_MSG(reg.size()>0,
+                     "[" + name() + "] Error!\n"
                      "        There are no products registered in the factory.\n"
                      "        Did you forget to call 'register_product'?\n");
 
-  auto it = m_register.find(key);
+  auto it = reg.find(key);
 
   // Check that the requested product is registered
-  EKAT_REQUIRE_MSG(it!=m_register.end(),
-                     "[" + m_factory_name + "] Error!\n"
+  EKAT_REQUIRE_MSG(it!=reg.end(),
+                     "[" + name() + "] Error!\n"
                      "        The key '" + key + "' is not associated to any registered product.\n"
-                     "        The list of registered product is: " + print_registered_products() + "\n"
+                     "        The list of registered product is: " + print_registered_products(reg) + "\n" +
+                     suggest_products(key) +
                      "        Did you forget to register it?\n");
 
   return (*it->second)(std::forward<ConstructorArgs>(args)...);
@@ -154,20 +250,22 @@ template<typename AbstractProduct,
 template<int OpStreamExists>
 typename std::enable_if<OpStreamExists==1,std::string>::type
 Factory<AbstractProduct,KeyType,PointerType,ConstructorArgs...>::
-print_registered_products_impl () const {
-  // This routine simply puts the products name in a string, as "name1, name2, name3,..., name N"
-  std::stringstream ss;
-
-  if (m_register.size()==0) {
-    return ss.str();
-  }
-  auto it = m_register.begin();
-  ss << it->first;
-  for (++it; it!=m_register.end(); ++it) {
-    ss << ", " << it->first;
+print_registered_products_impl (const register_type& reg) const {
+  // This routine simply puts the products name in a string, as "name1, name2, name3,..., name N".
+  // The names are sorted, so that the output does not depend on the order of a hash map.
+  std::vector<std::string> names;
+  for (const auto& it : reg) {
+    std::stringstream ss;
+    ss << it.first;
+    names.push_back(ss.str());
   }
+  std::sort(names.begin(),names.end());
 
-  return ss.str();
+  std::string s;
+  for (const auto& n : names) {
+    s += (s.empty() ? "" : ", ") + n;
+  }
+  return s;
 }
 
 } // namespace ekat
@@ -0,0 +1,212 @@
+#ifndef EKAT_INTERNED_MAP_HPP
+#define EKAT_INTERNED_MAP_HPP
+
+#include "ekat/util/ekat_string_interner.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace ekat {
+
+/*
+ * A map from interned strings (see StringInterner) to values.
+ *
+ * Keys are the integer ids of the interned strings, and are looked up in
+ * an open-addressing (linear probing) hash table, so that lookups never
+ * compare strings. Values are stored in a deque, in insertion order, so
+ * that references to them remain valid when new entries are added (like
+ * for std::map). Entries cannot be erased.
+ *
+ * Since ids depend on the order in which strings were interned, iteration
+ * over keys is done in lexicographic order of the key strings, so that
+ * the output of, e.g., printing functions is reproducible.
+ */
+
+template<typename ValueType>
+class InternedMap {
+  // Pairs (key string, position in m_entries)
+  using sorted_keys_t = std::vector<std::pair<const std::string*,int>>;
+public:
+
+  // Iterate over the keys (as strings), in lexicographic order.
+  // The begin iterator sorts the keys (and holds the sorted list), while the
+  // end iterator only stores the number of keys, so it is cheap to build.
+  class key_const_iterator {
+  public:
+    using iterator_category = std::bidirectional_iterator_tag;
+    using difference_type   = std::ptrdiff_t;
+    using value_type        = std::string;
+    using pointer           = const std::string*;
+    using reference         = const std::string&;
+
+    key_const_iterator (const InternedMap& map, const size_t pos, std::shared_ptr<const sorted_keys_t> keys)
+     : m_map(&map), m_pos(pos), m_keys(std::move(keys)) {}
+
+    pointer   operator-> () const { return  (*m_keys)[m_pos].first; }
+    reference operator*  () const { return *(*m_keys)[m_pos].first; }
+
+    key_const_iterator& operator++ ()    { ++m_pos; return *this; }
+    key_const_iterator  operator++ (int) { auto retval = *this; ++m_pos; return retval; }
+    key_const_iterator& operator-- ()    { sort_keys(); --m_pos; return *this; }
+    key_const_iterator  operator-- (int) { auto retval = *this; --*this; return retval; }
+
+    // Iterators are only comparable if they come from the same map
+    bool operator== (const key_const_iterator& other) const { return m_pos==other.m_pos; }
+    bool operator!= (const key_const_iterator& other) const { return m_pos!=other.m_pos; }
+  private:
+    // An end iterator only needs the keys if decremented
+    void sort_keys () {
+      if (not m_keys) {
+        m_keys = std::make_shared<const sorted_keys_t>(m_map->sorted_keys());
+      }
+    }
+
+    const InternedMap*                   m_map;
+    size_t                               m_pos;
+    std::shared_ptr<const sorted_keys_t> m_keys;
+  };
+
+  using entry_type = std::pair<int,ValueType>;
+
+  // Lookup by id. Return nullptr if not found.
+  ValueType* find (const int id) {
+    const int pos = position(id);
+    return pos>=0 ? &m_entries[pos].second : nullptr;
+  }
+  const ValueType* find (const int id) const {
+    const int pos = position(id);
+    return pos>=0 ? &m_entries[pos].second : nullptr;
+  }
+
+  // Lookup by string. Return nullptr if not found. Does not intern the string.
+  ValueType* find (const std::string& key) {
+    return find(StringInterner::find(key));
+  }
+  const ValueType* find (const std::string& key) const {
+    return find(StringInterner::find(key));
+  }
+
+  // If id is not in the map, add an entry, constructing the value from args.
+  // Return the stored value, and whether it was inserted.
+  template<typename... Args>
+  std::pair<ValueType*,bool> try_emplace (const int id, Args&&... args) {
+    if (ValueType* v = find(id)) {
+      return std::make_pair(v,false);
+    }
+
+    // Keep load factor <= 1/2
+    if (2*(m_entries.size()+1) > m_slots.size()) {
+      rehash(std::max<size_t>(16,2*m_slots.size()));
+    }
+    m_entries.emplace_back(std::piecewise_construct,
+                           std::forward_as_tuple(id),
+                           std::forward_as_tuple(std::forward<Args>(args)...));
+    m_slots[free_slot(id)] = static_cast<int>(m_entries.size()-1);
+    return std::make_pair(&m_entries.back().second,true);
+  }
+
+  template<typename... Args>
+  std::pair<ValueType*,bool> try_emplace (const std::string& key, Args&&... args) {
+    return try_emplace(StringInterner::intern(key),std::forward<Args>(args)...);
+  }
+
+  // Return the value for the given key, default constructing it if not present.
+  ValueType& operator[] (const int id) { return *try_emplace(id).first; }
+  ValueType& operator[] (const std::string& key) { return *try_emplace(key).first; }
+
+  size_t size  () const { return m_entries.size(); }
+  bool   empty () const { return m_entries.empty(); }
+
+  // Iterate over (id,value) pairs, in insertion order
+  typename std::deque<entry_type>::const_iterator begin () const { return m_entries.begin(); }
+  typename std::deque<entry_type>::const_iterator end   () const { return m_entries.end(); }
+
+  // Iterate over keys, in lexicographic order
+  key_const_iterator keys_cbegin () const {
+    return key_const_iterator(*this,0,std::make_shared<const sorted_keys_t>(sorted_keys()));
+  }
+  key_const_iterator keys_cend () const {
+    return key_const_iterator(*this,m_entries.size(),nullptr);
+  }
+
+  // Call f(key,value) for each entry, in lexicographic order of the keys
+  template<typename F>
+  void for_each_sorted (F&& f) const {
+    for (const auto& k : sorted_keys()) {
+      f(*k.first,m_entries[k.second].second);
+    }
+  }
+
+private:
+
+  static size_t hash (const int id, const int nbits) {
+    // Fibonacci hashing: the high bits of id*2^32/phi are well mixed
+    return (static_cast<std::uint32_t>(id)*2654435769u) >> (32-nbits);
+  }
+
+  // Position of id in m_entries, or -1 if not found
+  int position (const int id) const {
+    if (id<0 || m_slots.empty()) {
+      return -1;
+    }
+    const size_t mask = m_slots.size()-1;
+    for (size_t s = hash(id,m_nbits); ; s = (s+1) & mask) {
+      const int pos = m_slots[s];
+      if (pos<0 || m_entries[pos].first==id) {
+        return pos;
+      }
+    }
+  }
+
+  // First empty slot in the probing sequence of id
+  size_t free_slot (const int id) const {
+    const size_t mask = m_slots.size()-1;
+    size_t s = hash(id,m_nbits);
+    while (m_slots[s]>=0) {
+      s = (s+1) & mask;
+    }
+    return s;
+  }
+
+  void rehash (const size_t nslots) {
+    m_nbits = 0;
+    while ((size_t(1) << m_nbits) < nslots) {
+      ++m_nbits;
+    }
+    m_slots.assign(size_t(1) << m_nbits,-1);
+    for (size_t pos = 0; pos<m_entries.size(); ++pos) {
+      m_slots[free_slot(m_entries[pos].first)] = static_cast<int>(pos);
+    }
+  }
+
+  // The keys are sorted on each call, rather than cached, so that concurrent
+  // iterations over a const map do not modify it.
+  sorted_keys_t sorted_keys () const {
+    sorted_keys_t keys;
+    keys.reserve(m_entries.size());
+    for (size_t pos = 0; pos<m_entries.size(); ++pos) {
+      keys.emplace_back(&StringInterner::str(m_entries[pos].first),static_cast<int>(pos));
+    }
+    std::sort(keys.begin(),keys.end(),
+              [](const typename sorted_keys_t::value_type& a,
+                 const typename sorted_keys_t::value_type& b) {
+                return *a.first < *b.first;
+              });
+    return keys;
+  }
+
+  std::deque<entry_type>  m_entries;
+  std::vector<int>        m_slots;    // -1 if empty, otherwise position in m_entries
+  int                     m_nbits = 0;
+};
+
+} // namespace ekat
+
+#endif // EKAT_INTERNED_MAP_HPP
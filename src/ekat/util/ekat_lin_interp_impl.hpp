@@ -139,15 +139,10 @@ void LinInterp<ScalarT, PackSize, DeviceT>::setup_impl(
 
   const int i = col == -1 ? team.league_rank() : col;
   Kokkos::parallel_for(range_boundary, [&] (Int k2) {
-    for (int s = 0; s < Pack::n; ++s) {
-      const Scalar x2_indv = x2(k2)[s];
-      auto ub = upper_bound(begin_x1, end_x1, x2_indv);
-      int x1_idx = ub - begin_x1;
-      if (x1_idx > 0) {
-        --x1_idx;
-      }
-      m_indx_map(i, k2)[s] = x1_idx;
-    }
+    // Search all the entries of the x2 pack at once
+    auto x1_idx = upper_bound(begin_x1, end_x1, x2(k2));
+    x1_idx.set(x1_idx > 0, x1_idx - 1);
+    m_indx_map(i, k2) = x1_idx;
   });
 }
 
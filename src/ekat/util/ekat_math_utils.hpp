@@ -2,6 +2,7 @@
 #define EKAT_MATH_UTILS_HPP
 
 #include "ekat/ekat_scalar_traits.hpp"
+#include "ekat/ekat_macros.hpp"
 #include "ekat/ekat.hpp"
 
 #ifndef EKAT_ENABLE_GPU
@@ -102,39 +103,75 @@ struct TransposeDirection {
   enum Enum { c2f, f2c };
 };
 
+namespace impl {
+
+// Tile size for cache-blocked transposes: a tile of the source and one of
+// the destination (in double precision) fit comfortably in L1 cache.
+constexpr Int transpose_tile_size = 32;
+
+// Copy a batch of nb (ni x nj) matrices from src to dst, which use different
+// strides (in particular, for a transpose, different fast indices). The
+// matrices are processed one (ni x nj) tile at a time, so that both the
+// strided reads and the strided writes stay in cache, and tiles are
+// distributed across the threads of the default host execution space.
+// Note: the inner loop runs over i, so i should have unit stride in dst.
+template <typename Scalar>
+void blocked_strided_copy (const Scalar* src, Scalar* dv,
+                           const Int nb, const Int ni, const Int nj,
+                           const Int src_b, const Int src_i, const Int src_j,
+                           const Int dst_b, const Int dst_i, const Int dst_j)
+{
+  constexpr Int tile = transpose_tile_size;
+  const Int nti = (ni + tile - 1) / tile;
+  const Int ntj = (nj + tile - 1) / tile;
+
+  using policy_t = Kokkos::RangePolicy<Kokkos::DefaultHostExecutionSpace>;
+  Kokkos::parallel_for("ekat::transpose", policy_t(0, nb*nti*ntj), [=] (const Int t) {
+    const Int b  = t / (nti*ntj);
+    const Int tj = (t / nti) % ntj;
+    const Int ti = t % nti;
+
+    const Int ibeg = ti*tile;
+    const Int jbeg = tj*tile;
+    const Int iend = impl::min(ibeg+tile, ni);
+    const Int jend = impl::min(jbeg+tile, nj);
+
+    const Scalar* sb = src + b*src_b;
+    Scalar* db = dv + b*dst_b;
+    for (Int j = jbeg; j < jend; ++j) {
+      vector_simd for (Int i = ibeg; i < iend; ++i) {
+        db[i*dst_i + j*dst_j] = sb[i*src_i + j*src_j];
+      }
+    }
+  });
+}
+
+} // namespace impl
+
 // Switch whether i (column index) or k (level index) is the fast
 // index. TransposeDirection::c2f makes i faster; f2c makes k faster.
+// The transposition is cache-blocked, and runs in parallel on the
+// default host execution space.
 template <TransposeDirection::Enum direction, typename Scalar>
 void transpose(const Scalar* sv, Scalar* dv, Int ni, Int nk) {
-  for (Int k = 0; k < nk; ++k) {
-    for (Int i = 0; i < ni; ++i) {
-      const Int cidx = nk*i + k;
-      const Int fidx = ni*k + i;
-      if (direction == TransposeDirection::c2f) {
-        dv[fidx] = sv[cidx];
-      }
-      else {
-        dv[cidx] = sv[fidx];
-      }
-    }
+  // cidx = nk*i + k, fidx = ni*k + i
+  if (direction == TransposeDirection::c2f) {
+    impl::blocked_strided_copy(sv, dv, 1, ni, nk, 0, nk, 1, 0, 1, ni);
+  }
+  else {
+    impl::blocked_strided_copy(sv, dv, 1, nk, ni, 0, ni, 1, 0, 1, nk);
   }
 }
 
 template <TransposeDirection::Enum direction, typename Scalar>
 void transpose(const Scalar* sv, Scalar* dv, Int ni, Int nk, Int nj) {
-  for (Int j = 0; j < nj; ++j) {
-    for (Int k = 0; k < nk; ++k) {
-      for (Int i = 0; i < ni; ++i) {
-        const Int cidx = (nk*nj)*i + k*nj + j;
-        const Int fidx = (ni*nk)*j + k*ni + i;
-        if (direction == TransposeDirection::c2f) {
-          dv[fidx] = sv[cidx];
-        }
-        else {
-          dv[cidx] = sv[fidx];
-        }
-      }
-    }
+  // cidx = (nk*nj)*i + k*nj + j, fidx = (ni*nk)*j + k*ni + i
+  // For each k, this is a 2d transpose in the (i,j) plane.
+  if (direction == TransposeDirection::c2f) {
+    impl::blocked_strided_copy(sv, dv, nk, ni, nj, nj, nk*nj, 1, ni, 1, ni*nk);
+  }
+  else {
+    impl::blocked_strided_copy(sv, dv, nk, nj, ni, ni, ni*nk, 1, nj, 1, nk*nj);
   }
 }
 
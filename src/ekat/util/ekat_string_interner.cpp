@@ -0,0 +1,138 @@
+#include "ekat/util/ekat_string_interner.hpp"
+#include "ekat/ekat_assert.hpp"
+
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace ekat {
+
+namespace {
+
+struct Node {
+  Node (const std::string& s, const size_t h, const int i) : str(s), hash(h), id(i) {}
+
+  const std::string str;
+  const size_t      hash;
+  const int         id;
+};
+
+// An open-addressing (linear probing) table of nodes, plus the nodes indexed
+// by id. Once published, a table is only modified by filling empty slots, so
+// readers can probe it without locking.
+struct Table {
+  explicit Table (const size_t nslots)
+   : mask  (nslots-1)
+   , slots (new std::atomic<const Node*>[nslots])
+   , by_id (new std::atomic<const Node*>[nslots/2])
+  {
+    for (size_t i=0; i<nslots; ++i) {
+      slots[i].store(nullptr,std::memory_order_relaxed);
+    }
+  }
+
+  // Max number of nodes, to keep the load factor <= 1/2
+  int capacity () const { return static_cast<int>((mask+1)/2); }
+
+  const size_t                                mask;
+  std::unique_ptr<std::atomic<const Node*>[]> slots;
+  std::unique_ptr<std::atomic<const Node*>[]> by_id;
+  std::atomic<int>                            size {0};
+};
+
+struct InternTable {
+  InternTable () {
+    tables.emplace_back(new Table(64));
+    current.store(tables.back().get(),std::memory_order_release);
+  }
+
+  // Serializes writers (readers never lock)
+  std::mutex mutex;
+
+  // Nodes are never moved, so tables can store pointers to them
+  std::deque<Node> nodes;
+
+  // When the current table is full, a larger one is published. Old tables
+  // are kept alive, since readers may still be probing them. Since sizes
+  // double, they use at most as much memory as the current one.
+  std::vector<std::unique_ptr<Table>> tables;
+  std::atomic<Table*>                 current;
+};
+
+InternTable& intern_table () {
+  static InternTable table;
+  return table;
+}
+
+// Return the node for s (with hash h) in t, or nullptr if not found
+const Node* lookup (const Table& t, const std::string& s, const size_t h) {
+  for (size_t i = h & t.mask; ; i = (i+1) & t.mask) {
+    const Node* n = t.slots[i].load(std::memory_order_acquire);
+    if (n==nullptr || (n->hash==h && n->str==s)) {
+      return n;
+    }
+  }
+}
+
+// Add n to t (the caller must hold the writers' mutex)
+void insert (Table& t, const Node* n) {
+  t.by_id[n->id].store(n,std::memory_order_relaxed);
+  size_t i = n->hash & t.mask;
+  while (t.slots[i].load(std::memory_order_relaxed)!=nullptr) {
+    i = (i+1) & t.mask;
+  }
+  t.slots[i].store(n,std::memory_order_release);
+  t.size.store(n->id+1,std::memory_order_release);
+}
+
+} // anonymous namespace
+
+int StringInterner::intern (const std::string& s) {
+  auto& t = intern_table();
+  const size_t h = std::hash<std::string>()(s);
+
+  // Fast path: s was already interned
+  if (const Node* n = lookup(*t.current.load(std::memory_order_acquire),s,h)) {
+    return n->id;
+  }
+
+  std::lock_guard<std::mutex> lock(t.mutex);
+
+  // Another thread may have interned s in the meantime
+  Table* table = t.current.load(std::memory_order_relaxed);
+  if (const Node* n = lookup(*table,s,h)) {
+    return n->id;
+  }
+
+  const int id = static_cast<int>(t.nodes.size());
+  if (id==table->capacity()) {
+    t.tables.emplace_back(new Table(2*(table->mask+1)));
+    table = t.tables.back().get();
+    for (const auto& n : t.nodes) {
+      insert(*table,&n);
+    }
+    t.current.store(table,std::memory_order_release);
+  }
+
+  t.nodes.emplace_back(s,h,id);
+  insert(*table,&t.nodes.back());
+  return id;
+}
+
+int StringInterner::find (const std::string& s) {
+  const Table& t = *intern_table().current.load(std::memory_order_acquire);
+  const Node* n = lookup(t,s,std::hash<std::string>()(s));
+  return n==nullptr ? -1 : n->id;
+}
+
+const std::string& StringInterner::str (const int id) {
+  const Table& t = *intern_table().current.load(std::memory_order_acquire);
+  EKAT_REQUIRE_MSG (id>=0 && id<t.size.load(std::memory_order_acquire),
+      "Error! Invalid interned string id " + std::to_string(id) + ".\n");
+  return t.by_id[id].load(std::memory_order_relaxed)->str;
+}
+
+} // namespace ekat
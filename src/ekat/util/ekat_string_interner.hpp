@@ -0,0 +1,37 @@
+#ifndef EKAT_STRING_INTERNER_HPP
+#define EKAT_STRING_INTERNER_HPP
+
+#include <string>
+
+namespace ekat {
+
+/*
+ * A process-wide table of interned strings.
+ *
+ * Each distinct string is assigned a unique, non-negative integer id the
+ * first time it is interned. Ids can then be hashed/compared in place of
+ * the strings themselves. Interned strings are never removed, so the
+ * reference returned by 'str' is valid until the end of the program.
+ * Ids depend on the order in which strings are interned, so they should
+ * not be used for ordering, nor be stored across runs.
+ *
+ * All methods are thread safe. Lookups (find, str, and intern of a string
+ * that is already interned) do not lock, so concurrent readers do not
+ * serialize; only interning a new string takes a lock.
+ */
+
+class StringInterner {
+public:
+  // Return the id of s, interning it first if needed
+  static int intern (const std::string& s);
+
+  // Return the id of s, or -1 if s was never interned
+  static int find (const std::string& s);
+
+  // Return the string with given id
+  static const std::string& str (const int id);
+};
+
+} // namespace ekat
+
+#endif // EKAT_STRING_INTERNER_HPP
@@ -0,0 +1,235 @@
+#ifndef EKAT_STRING_REF_HPP
+#define EKAT_STRING_REF_HPP
+
+#include "ekat/ekat_assert.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <ostream>
+#include <string>
+
+namespace ekat {
+
+/*
+ * A non-owning reference to a sequence of chars (pointer+length).
+ *
+ * This is a minimal replacement for C++17's std::string_view, which allows
+ * to inspect and tokenize strings without allocating new std::string
+ * objects. As with std::string_view, the referenced chars must outlive
+ * the StringRef object, and are not necessarily null-terminated.
+ */
+
+class StringRef {
+public:
+  using const_iterator = const char*;
+
+  static constexpr size_t npos = std::string::npos;
+
+  StringRef () = default;
+  StringRef (const char* data, const size_t size) : m_data(data), m_size(size) {}
+  StringRef (const char* s) : m_data(s), m_size(std::strlen(s)) {}
+  StringRef (const std::string& s) : m_data(s.data()), m_size(s.size()) {}
+
+  const char* data  () const { return m_data; }
+  size_t      size  () const { return m_size; }
+  bool        empty () const { return m_size==0; }
+
+  const_iterator begin () const { return m_data; }
+  const_iterator end   () const { return m_data+m_size; }
+
+  char operator[] (const size_t i) const { return m_data[i]; }
+  char front () const { return m_data[0]; }
+  char back  () const { return m_data[m_size-1]; }
+
+  // The chars in [pos,pos+n) (or up to the end, if the string is shorter)
+  StringRef substr (const size_t pos, const size_t n = npos) const {
+    EKAT_ASSERT_MSG (pos<=m_size, "Error! StringRef::substr position out of bounds.\n");
+    return StringRef(m_data+pos,std::min(n,m_size-pos));
+  }
+
+  size_t find (const char c, const size_t pos = 0) const {
+    for (size_t i=pos; i<m_size; ++i) {
+      if (m_data[i]==c) return i;
+    }
+    return npos;
+  }
+  size_t find (const StringRef s, const size_t pos = 0) const {
+    if (pos>m_size || s.size()>m_size-pos) {
+      return npos;
+    }
+    if (s.empty()) {
+      return pos;
+    }
+    const auto it = std::search(begin()+pos,end(),s.begin(),s.end());
+    return it==end() ? npos : it-begin();
+  }
+
+  // Position of the first char (not) in chars
+  size_t find_first_of (const StringRef chars, const size_t pos = 0) const {
+    for (size_t i=pos; i<m_size; ++i) {
+      if (chars.find(m_data[i])!=npos) return i;
+    }
+    return npos;
+  }
+  size_t find_first_not_of (const StringRef chars, const size_t pos = 0) const {
+    for (size_t i=pos; i<m_size; ++i) {
+      if (chars.find(m_data[i])==npos) return i;
+    }
+    return npos;
+  }
+
+  bool starts_with (const StringRef s) const {
+    return s.size()<=m_size && std::equal(s.begin(),s.end(),begin());
+  }
+
+  std::string str () const { return std::string(m_data,m_size); }
+
+private:
+  const char* m_data = "";
+  size_t      m_size = 0;
+};
+
+inline bool operator== (const StringRef lhs, const StringRef rhs) {
+  return lhs.size()==rhs.size() && std::equal(lhs.begin(),lhs.end(),rhs.begin());
+}
+inline bool operator!= (const StringRef lhs, const StringRef rhs) {
+  return not (lhs==rhs);
+}
+inline bool operator< (const StringRef lhs, const StringRef rhs) {
+  return std::lexicographical_compare(lhs.begin(),lhs.end(),rhs.begin(),rhs.end());
+}
+
+inline std::ostream& operator<< (std::ostream& out, const StringRef s) {
+  return out.write(s.data(),s.size());
+}
+
+/*
+ * A lazy range over the tokens of a string. Tokens are computed while
+ * iterating, and are returned as StringRef's into the input string,
+ * so that no memory is allocated.
+ *
+ * Use the functions tokenize/tokenize_any (below) to create a TokenRange.
+ */
+
+class TokenRange {
+public:
+  enum Mode {
+    Delimiter,  // Split at every occurrence of the delimiter string, keeping empty tokens
+    AnyOf       // Split at any of the delimiter chars, skipping empty tokens
+  };
+
+  class const_iterator {
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using difference_type   = std::ptrdiff_t;
+    using value_type        = StringRef;
+    using pointer           = const StringRef*;
+    using reference         = const StringRef&;
+
+    const_iterator () = default;
+
+    reference operator*  () const { return m_token; }
+    pointer   operator-> () const { return &m_token; }
+
+    const_iterator& operator++ () { advance(); return *this; }
+    const_iterator  operator++ (int) { auto retval = *this; advance(); return retval; }
+
+    bool operator== (const const_iterator& rhs) const {
+      return m_done==rhs.m_done && (m_done || m_token.data()==rhs.m_token.data());
+    }
+    bool operator!= (const const_iterator& rhs) const { return not (*this==rhs); }
+
+  private:
+    friend class TokenRange;
+
+    const_iterator (const TokenRange& range)
+     : m_str(range.m_str), m_delims(range.m_delims), m_mode(range.m_mode), m_done(false)
+    {
+      m_next = 0;
+      advance();
+    }
+
+    void advance () {
+      const size_t size = m_str.size();
+      if (m_next>size) {
+        m_done = true;
+        return;
+      }
+
+      size_t first = m_next;
+      size_t last;
+      if (m_mode==Delimiter) {
+        last = m_str.find(m_delims,first);
+        if (last==StringRef::npos) {
+          last = size;
+          m_next = size+1;
+        } else {
+          m_next = last + m_delims.size();
+        }
+      } else {
+        first = m_str.find_first_not_of(m_delims,first);
+        if (first==StringRef::npos) {
+          m_done = true;
+          return;
+        }
+        last = m_str.find_first_of(m_delims,first);
+        if (last==StringRef::npos) {
+          last = size;
+        }
+        m_next = last+1;
+      }
+      m_token = m_str.substr(first,last-first);
+    }
+
+    StringRef m_str;
+    StringRef m_delims;
+    Mode      m_mode = Delimiter;
+    StringRef m_token;
+    size_t    m_next = 0;
+    bool      m_done = true;
+  };
+
+  TokenRange (const StringRef str, const StringRef delims, const Mode mode)
+   : m_str(str), m_delims(delims), m_mode(mode)
+  {
+    EKAT_REQUIRE_MSG (mode==AnyOf || not delims.empty(),
+        "Error! Cannot tokenize a string with an empty delimiter.\n");
+  }
+
+  const_iterator begin () const { return const_iterator(*this); }
+  const_iterator end   () const { return const_iterator(); }
+
+private:
+  StringRef m_str;
+  StringRef m_delims;
+  Mode      m_mode;
+};
+
+// Tokens between occurrences of delim (including empty ones). Like split,
+// this always yields at least one token (possibly empty).
+inline TokenRange tokenize (const StringRef str, const StringRef delim) {
+  return TokenRange(str,delim,TokenRange::Delimiter);
+}
+
+// Maximal non-empty substrings not containing any of the chars in delims
+inline TokenRange tokenize_any (const StringRef str, const StringRef delims) {
+  return TokenRange(str,delims,TokenRange::AnyOf);
+}
+
+// Trim leading/trailing characters matching given one
+inline StringRef trim_ref (const StringRef s, const char c) {
+  size_t first = 0;
+  size_t last  = s.size();
+  while (first<last && s[first]==c) {
+    ++first;
+  }
+  while (last>first && s[last-1]==c) {
+    --last;
+  }
+  return s.substr(first,last-first);
+}
+
+} // namespace ekat
+
+#endif // EKAT_STRING_REF_HPP
@@ -2,7 +2,8 @@
 #include "ekat/ekat_assert.hpp"
 
 #include <algorithm>
-#include <set>
+#include <cctype>
+#include <cstdint>
 #include <sstream>
 #include <list>
 
@@ -18,39 +19,14 @@ void strip (std::string& str, const char c) {
 
 std::vector<std::string> split(const std::string& str, const std::string& delim) {
   std::vector<std::string> tokens;
-
-  auto start = 0;
-  auto pos = str.find(delim);
-  while (pos!=std::string::npos) {
-    tokens.push_back(str.substr(start,pos-start));
-    start = pos + delim.size();
-    pos = str.find(delim,start);
+  for (const auto& t : tokenize(str,delim)) {
+    tokens.emplace_back(t.data(),t.size());
   }
-
-  // Don't forget to add the substring from the last occurrence of 'delim' (if any) to the end of str
-  tokens.push_back(str.substr(start));
   return tokens;
 }
 
-bool starts_with (const std::string& s, const std::string& start) {
-  return s.substr(0,start.size())==start;
-}
-
 std::string trim (const std::string& s, const char c) {
-  if (s=="") {
-    return s;
-  }
-  int nl = 0;
-  while (s[nl] == c) {
-    ++nl;
-  }
-  int size = s.size();
-  int nt = 0;
-  while (nt<size && s[size-nt-1] == c) {
-    ++nt;
-  }
-
-  return s.substr(nl,size-nl-nt);
+  return trim_ref(s,c).str();
 }
 
 std::string strint (const std::string& s, const int i) {
@@ -202,63 +178,57 @@ bool valid_nested_list_format (const std::string& str)
   return num_open==0;
 }
 
-ParameterList parse_nested_list (std::string str)
-{
-  constexpr auto npos = std::string::npos;
-
-  // 1. Strip spaces
-  strip(str,' ');
+namespace {
 
-  // 2. Verify input is valid
-  EKAT_REQUIRE_MSG (valid_nested_list_format(str),
-      "Error! Input std::string '" + str + "' is not a valid (nested) list.\n");
+// Parse a (validated) nested list, recursing on sublists
+ParameterList parse_nested_list_impl (const StringRef str)
+{
+  constexpr auto npos = StringRef::npos;
 
   const char open_char  = str.front();
   const char close_char = str.back();
-  std::string brackets;
-  brackets += open_char;
-  brackets += close_char;
+  const char brackets[] = {open_char, close_char};
 
   // Find the closing bracket matching the open one at open_pos
-  auto find_closing = [&] (const std::string& s, size_t open_pos) ->size_t {
+  auto find_closing = [&] (size_t open_pos) ->size_t {
     int num_open = 0;
     auto pos = open_pos;
     auto prev = npos;
     do {
       prev = pos;
-      if (s[prev]==close_char) {
+      if (str[prev]==close_char) {
         --num_open;
       } else {
         ++num_open;
       }
-      pos = s.find_first_of(brackets,prev+1);
+      pos = str.find_first_of(StringRef(brackets,2),prev+1);
     } while (num_open>0 && pos!=npos);
 
     return prev;
   };
 
-  // 3. Loop through each entry, recursing when finding a nested list
+  // Loop through each entry, recursing when finding a nested list
   int num_entries = 0;
   int depth_max = 1;
 
-  std::string separators = brackets + ",";
+  const char separators[] = {open_char, close_char, ','};
+  const StringRef seps(separators,3);
   size_t start = 1; // We know str[0] = $open
-  size_t pos = str.find_first_of(separators,start);
+  size_t pos = str.find_first_of(seps,start);
 
-  ParameterList list (str);
+  ParameterList list (str.str());
   while (pos!=npos) {
     if (str[pos]==open_char) {
       // A sublist. Find the closing bracket, and recurse on substring.
       // NOTE: we *know* close!=npos, cause we already validated str.
-      auto close = find_closing(str,pos);
-      auto substr = str.substr(pos,close-pos+1);
-      auto sublist = parse_nested_list(substr);
+      auto close = find_closing(pos);
+      auto& sublist = list.sublist(strint("Entry",num_entries));
+      sublist = parse_nested_list_impl(str.substr(pos,close-pos+1));
       sublist.rename(strint("Entry",num_entries));
 
       list.set<std::string>(strint("Type",num_entries),"List");
-      list.sublist(strint("Entry",num_entries)) = sublist;
       depth_max = std::max(depth_max,1+sublist.get<int>("Depth"));
-      
+
       // After a list closes, we always have either ',' or ']' afterwards.
       // So we expect str[pos+1] to be a special char, but there is no
       // item between ']' and ','/']', so we might as well start the
@@ -266,27 +236,42 @@ ParameterList parse_nested_list (std::string str)
       start = close+2;
     } else {
       // A normal entry.
-      auto substr = str.substr(start,pos-start);
       list.set<std::string>(strint("Type",num_entries),"Value");
-      list.set(strint("Entry",num_entries),substr);
-      
+      list.set(strint("Entry",num_entries),str.substr(start,pos-start).str());
+
       // Make next search start from the next char
       start = pos+1;
     }
 
     // Update current status, and continue
     ++num_entries;
-    pos = str.find_first_of(separators,start);
+    pos = str.find_first_of(seps,start);
   }
 
   list.set("Num Entries",num_entries);
   list.set("Depth",depth_max);
-  list.set("String",str);
+  list.set("String",str.str());
 
   return list;
 }
 
-double jaro_similarity (const std::string& s1, const std::string& s2) {
+} // anonymous namespace
+
+ParameterList parse_nested_list (std::string str)
+{
+  // 1. Strip spaces
+  strip(str,' ');
+
+  // 2. Verify input is valid. Sublists of a valid list are valid, so we
+  //    do not need to re-validate them while recursing.
+  EKAT_REQUIRE_MSG (valid_nested_list_format(str),
+      "Error! Input std::string '" + str + "' is not a valid (nested) list.\n");
+
+  // 3. Parse, without making copies of substrings
+  return parse_nested_list_impl(str);
+}
+
+double jaro_similarity (const StringRef s1, const StringRef s2) {
   // Two equal strings always have similarity of 1, regardless of whether they are empty or not
   if (s1==s2) {
     return 1;
@@ -296,9 +281,20 @@ double jaro_similarity (const std::string& s1, const std::string& s2) {
   const int len2 = s2.size();
   const int max_dist = std::max(len1,len2)/2 - 1;
 
+  // Flags for matched chars. Use a stack buffer for (common) short strings,
+  // so that no memory is allocated.
+  constexpr int max_stack_len = 256;
+  char stack_buf[max_stack_len];
+  std::vector<char> heap_buf;
+  char* s1_matches = stack_buf;
+  if (len1+len2>max_stack_len) {
+    heap_buf.resize(len1+len2);
+    s1_matches = heap_buf.data();
+  }
+  char* s2_matches = s1_matches + len1;
+  std::fill_n(s1_matches,len1+len2,0);
+
   double matches = 0;
-  std::vector<int> s1_matches(len1,0);
-  std::vector<int> s2_matches(len2,0);
   for (int i=0; i<len1; ++i) {
     for (int j=std::max(0,i-max_dist); j<std::min(len2,i+max_dist+1); ++j) {
       if (s1[i]==s2[j] && s2_matches[j]==0) {
@@ -332,18 +328,18 @@ double jaro_similarity (const std::string& s1, const std::string& s2) {
   return ( matches/len1 + matches/len2 + (matches-transp)/matches ) / 3.0;
 }
 
-double jaro_winkler_similarity (const std::string& s1, const std::string& s2,
+double jaro_winkler_similarity (const StringRef s1, const StringRef s2,
                                 const int l, const double p, const double thresh) {
   EKAT_ASSERT_MSG (l>=0 && l<=4, "Error! Jaro-Winkler similarity requries 0<=L<=4.\n");
   EKAT_ASSERT_MSG (p>=0 && p<=1.0/l, "Error! Jaro-Winkler similarity requries 0<=p<=1/L.\n");
   EKAT_ASSERT_MSG (thresh>0 && thresh<1.0, "Error! Jaro-Winkler boosh thresholt requries 0<thresh<1.\n");
 
-  double sim_j = jaro_similarity(s1,s2);;
+  double sim_j = jaro_similarity(s1,s2);
 
   if (sim_j>thresh) {
     const int end = std::min(static_cast<int>(std::min(s1.size(),s2.size())),l);
     int common_prefix_len = 0;
-    while (s1[common_prefix_len]==s2[common_prefix_len] && common_prefix_len<end) {
+    while (common_prefix_len<end && s1[common_prefix_len]==s2[common_prefix_len]) {
       ++common_prefix_len;
     }
     sim_j += common_prefix_len*p*(1-sim_j);
@@ -357,79 +353,56 @@ std::list<std::string> gather_tokens(const std::string& s,
                                      const std::vector<char>& delimiters,
                                      const std::string& atomic) {
   std::list<std::string> all_tokens;
-  std::string delim_str;
-  for (char delim: delimiters) {
-    delim_str.append(1, delim);
+  for (const auto& t : gather_tokens_ref(s,StringRef(delimiters.data(),delimiters.size()),atomic)) {
+    all_tokens.emplace_back(t.data(),t.size());
   }
+  return all_tokens;
+}
 
-  if (atomic!="") {
-    auto pos = s.find(atomic);
-    if (pos==std::string::npos) {
-      // The atomic string wasn't found.
-      return gather_tokens(s,delimiters,"");
-    }
-    // The atomic string was found. Add it as a token, then remove if from
-    // the input string, and run again on what's left.
-    // But first, we need to check that the string is delimited left and right
-    // by a delimiter (or string boundaries), otherwise it doesn't count.
-    auto slen = s.size();
-    auto alen = atomic.size();
-
-    // These lambda implement exactly what you think they do,
-    // but are more verbose than the corresponding checks when used.
-    auto at_s_start = [&] () -> bool {
-      return pos==0;
-    };
-    auto at_s_end = [&] () -> bool {
-      return (pos+alen)==slen;
-    };
-    auto delim_before = [&] () -> bool {
-      return s.find_first_of(delim_str,pos-1)==(pos-1);
-    };
-    auto delim_after = [&] () -> bool {
-      return s.find_first_of(delim_str,pos+alen)==(pos+alen);
-    };
-
-    if ( !at_s_start() && !delim_before() ) {
-      // The atomic string is not at the start of s, but it is
-      // not preceeded by a delimiter.
-      // So fall back to the case where we don't search for atomic
-      return gather_tokens(s,delimiters,"");
-    } else if ( !at_s_end() && !delim_after() ) {
-      // The atomic string is not at the end of s, but it is
-      // not followed by a delimiter.
-      // So fall back to the case where we don't search for atomic
-      return gather_tokens(s,delimiters,"");
-    }
+std::vector<StringRef> gather_tokens_ref(const StringRef s,
+                                         const StringRef delimiters,
+                                         const StringRef atomic) {
+  std::vector<StringRef> tokens;
 
-    // If we didn't hit any of the previous return statements, then the atomic
-    // substring was found, and it is a sub-token.
-    all_tokens.push_back(atomic);
+  // The parts of s left after removing the atomic strings (if any)
+  StringRef rest = s;
+  std::vector<StringRef> pieces;
 
-    std::string s_mod(s);
-    auto erase_begin = at_s_start() ? 0 : pos-1;
-    auto erase_len   = delim_after() ? alen+1 : alen;
-    s_mod.erase(erase_begin,erase_len);
+  if (not atomic.empty()) {
+    auto is_delim = [&](const char c) {
+      return delimiters.find(c)!=StringRef::npos;
+    };
+    const char* s_end = s.data()+s.size();
+
+    auto pos = rest.find(atomic);
+    while (pos!=StringRef::npos) {
+      // The atomic string counts as a token only if it is delimited left and
+      // right by a delimiter (or string boundaries). Otherwise, we stop
+      // searching, and simply tokenize what's left
+      const char* a_beg = rest.data()+pos;
+      const char* a_end = a_beg+atomic.size();
+      const bool delim_before = a_beg==s.data() || is_delim(a_beg[-1]);
+      const bool delim_after  = a_end==s_end    || is_delim(*a_end);
+      if (not delim_before || not delim_after) {
+        break;
+      }
 
-    // Note: splice is better than manual push back, since it only moves a couple of ptrs.
-    all_tokens.splice(all_tokens.end(),gather_tokens(s_mod,delimiters,atomic));
-    return all_tokens;
+      // Atomic tokens come first, then the tokens of the remaining pieces
+      tokens.push_back(atomic);
+      pieces.push_back(rest.substr(0,pos));
+      rest = rest.substr(pos+atomic.size());
+      pos = rest.find(atomic);
+    }
   }
+  pieces.push_back(rest);
 
-  std::size_t prev = 0, pos;
-  std::stringstream sstr(s);
-  while ((pos = s.find_first_of(delim_str, prev)) != std::string::npos)
-  {
-    if (pos > prev) {
-      all_tokens.push_back(s.substr(prev, pos-prev));
+  for (const auto& p : pieces) {
+    for (const auto& t : tokenize_any(p,delimiters)) {
+      tokens.push_back(t);
     }
-    prev = pos+1;
-  }
-  if (prev < s.length()) {
-    all_tokens.push_back(s.substr(prev, std::string::npos));
   }
 
-  return all_tokens;
+  return tokens;
 }
 
 double jaccard_similarity (const std::string& s1, const std::string& s2,
@@ -443,88 +416,107 @@ double jaccard_similarity (const std::string& s1, const std::string& s2,
     return static_cast<double>(s1==s2);
   }
   // Break the first and second strings up into tokens using all given
-  // delimiters.
-  std::list<std::string> s1_tokens, s2_tokens;
-  std::set<std::string> s1_set, s2_set;
+  // delimiters. Tokens reference s1/s2 chars, so no string is copied.
+  const StringRef delims(delimiters.data(),delimiters.size());
+  std::vector<StringRef> s1_tokens, s2_tokens;
 
   if (tokenize_s1) {
     if (tokenize_s2) {
-      s2_tokens = gather_tokens(s2, delimiters);
-      s1_tokens = gather_tokens(s1, delimiters);
+      s2_tokens = gather_tokens_ref(s2, delims);
+      s1_tokens = gather_tokens_ref(s1, delims);
     } else {
       // S2 is a single token
       s2_tokens.push_back(s2);
-      s1_tokens = gather_tokens(s1, delimiters, s2);
+      s1_tokens = gather_tokens_ref(s1, delims, s2);
     }
   } else {
     // We already took care of the case were we don't tokenize either one,
     // so we can be sure tokenize_s2 is true.
-    // S2 is a single token
-      if (s2=="zenith_angle") {
-        printf("zenith_angle\n");
-      }
+    // S1 is a single token
     s1_tokens.push_back(s1);
-    s2_tokens = gather_tokens(s2, delimiters, s1);
+    s2_tokens = gather_tokens_ref(s2, delims, s1);
   }
-  s1_set = std::set<std::string>(s1_tokens.begin(), s1_tokens.end());
-  s2_set = std::set<std::string>(s2_tokens.begin(), s2_tokens.end());
 
-  // Compute the intersection of the two sets of tokens.
-  std::vector<std::string> s_intersection(std::max(s1_set.size(), s2_set.size()));
-  auto iter = std::set_intersection(s1_set.begin(), s1_set.end(),
-                                    s2_set.begin(), s2_set.end(),
-                                    s_intersection.begin());
-  s_intersection.resize(iter - s_intersection.begin());
+  // Turn the lists of tokens into (sorted) sets
+  auto make_set = [](std::vector<StringRef> tokens) {
+    std::sort(tokens.begin(),tokens.end());
+    tokens.erase(std::unique(tokens.begin(),tokens.end()),tokens.end());
+    return tokens;
+  };
+  const auto s1_set = make_set(s1_tokens);
+  const auto s2_set = make_set(s2_tokens);
+
+  // Compute the size of the intersection of the two sets of tokens.
+  size_t int_count = 0;
+  for (auto it1=s1_set.begin(), it2=s2_set.begin(); it1!=s1_set.end() && it2!=s2_set.end(); ) {
+    if (*it1<*it2) {
+      ++it1;
+    } else if (*it2<*it1) {
+      ++it2;
+    } else {
+      ++int_count;
+      ++it1;
+      ++it2;
+    }
+  }
 
   // The Jaccard index is the ratio of the size of the intersection to that
   // of the union.
-  double int_size = static_cast<double>(s_intersection.size());
+  double int_size = static_cast<double>(int_count);
   double un_size = static_cast<double>(s1_tokens.size() + s2_tokens.size() - int_size);
   return int_size / un_size;
 }
 
 // ===================== Case Insensitive String ================== //
 
-bool caseInsensitiveEqualString (const std::string& s1, const std::string& s2) {
-  auto charComp = [](const char c1, const char c2)->bool{
-    return c1==c2 || std::toupper(c1)==std::toupper(c2);
-  };
-  return s1.size()==s2.size() &&
-         std::equal(s1.begin(),s1.end(),s2.begin(),charComp);
+namespace {
+inline int upper (const char c) {
+  return std::toupper(static_cast<unsigned char>(c));
 }
 
-bool caseInsensitiveLessString (const std::string& s1, const std::string& s2) {
-  auto charCompLess = [](const char c1, const char c2)->bool{
-    return std::toupper(c1)<std::toupper(c2);
-  };
-  auto charCompEq = [](const char c1, const char c2)->bool{
-    return std::toupper(c1)==std::toupper(c2);
-  };
-  for (auto it1=s1.begin(),it2=s2.begin(); it1!=s1.end() && it2!=s2.end(); ++it1,++it2) {
-    if (charCompLess(*it1,*it2)) {
-      return true;
-    } else if (!charCompEq(*it1,*it2)) {
-      return false;
+// Compare the two strings up to the first mismatch (case insensitive).
+// Return <0, 0, >0 as strcmp would.
+int caseInsensitiveCompare (const StringRef s1, const StringRef s2) {
+  const size_t n = std::min(s1.size(),s2.size());
+  for (size_t i=0; i<n; ++i) {
+    const int c1 = upper(s1[i]);
+    const int c2 = upper(s2[i]);
+    if (c1!=c2) {
+      return c1<c2 ? -1 : 1;
     }
   }
-  return s1.size()<s2.size();
+  return s1.size()==s2.size() ? 0 : (s1.size()<s2.size() ? -1 : 1);
 }
+} // anonymous namespace
 
-bool caseInsensitiveLessEqualString (const std::string& s1, const std::string& s2) {
-  auto charCompLess = [](const char c1, const char c2)->bool{
-    return std::toupper(c1)<std::toupper(c2);
-  };
-  auto charCompEq = [](const char c1, const char c2)->bool{
-    return std::toupper(c1)==std::toupper(c2);
-  };
-  for (auto it1=s1.begin(),it2=s2.begin(); it1!=s1.end() && it2!=s2.end(); ++it1,++it2) {
-    if (charCompLess(*it1,*it2)) {
-      return true;
-    } else if (!charCompEq(*it1,*it2)) {
+bool caseInsensitiveEqualString (const StringRef s1, const StringRef s2) {
+  if (s1.size()!=s2.size()) {
+    return false;
+  }
+  for (size_t i=0; i<s1.size(); ++i) {
+    if (s1[i]!=s2[i] && upper(s1[i])!=upper(s2[i])) {
       return false;
     }
   }
-  return s1.size()<=s2.size();
+  return true;
+}
+
+bool caseInsensitiveLessString (const StringRef s1, const StringRef s2) {
+  return caseInsensitiveCompare(s1,s2)<0;
+}
+
+bool caseInsensitiveLessEqualString (const StringRef s1, const StringRef s2) {
+  return caseInsensitiveCompare(s1,s2)<=0;
+}
+
+size_t caseInsensitiveHash (const StringRef s) {
+  // FNV-1a, on upper case chars
+  std::uint64_t h = 14695981039346656037ull;
+  for (const char c : s) {
+    h ^= static_cast<std::uint64_t>(upper(c));
+    h *= 1099511628211ull;
+  }
+  return static_cast<size_t>(h);
 }
 
 } // namespace ekat
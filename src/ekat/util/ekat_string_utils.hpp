@@ -2,6 +2,7 @@
 #define EKAT_STRING_UTILS_HPP
 
 #include <ekat/ekat_parameter_list.hpp>
+#include <ekat/util/ekat_string_ref.hpp>
 
 #include <sstream>
 #include <string>
@@ -21,6 +22,9 @@
  *  - Some utility functions to manipulate std::string objects, such as
  *    removing leading/trailing whitespaces, split a string into substrings
  *    at every occurrence of a given char, and more.
+ *
+ * Non-allocating versions of the tokenizing utilities (working on StringRef
+ * objects, and returning lazy ranges of tokens) are in ekat_string_ref.hpp.
  */
 
 namespace ekat {
@@ -36,7 +40,9 @@ inline std::vector<std::string> split(const std::string& str, const char delim)
 }
 
 // Checks if string begins with given substring
-bool starts_with (const std::string& s, const std::string& start);
+inline bool starts_with (const StringRef s, const StringRef start) {
+  return s.starts_with(start);
+}
 
 // Trim leading/trailing characters matching given one (default: whitespace).
 std::string trim (const std::string& s, const char c = ' ');
@@ -146,6 +152,11 @@ std::list<std::string> gather_tokens(const std::string& s,
                                      const std::vector<char>& delimiters,
                                      const std::string& atomic = "");
 
+// Same as above, but tokens reference the chars of the input string.
+std::vector<StringRef> gather_tokens_ref(const StringRef s,
+                                         const StringRef delimiters,
+                                         const StringRef atomic = "");
+
 // Utils to verify/parse a string encoding nested lists,
 // such as '[a,b,[c,d],e]'
 bool valid_nested_list_format (const std::string& str);
@@ -158,7 +169,7 @@ ParameterList parse_nested_list (std::string str);
 // a wrong string keyword is used, but the code has a pool of valid
 // strings to check the input against, and provide potential matches,
 // like with "string 'balh' not found; did you mean 'blah'?"
-double jaro_similarity (const std::string& s1, const std::string& s2);
+double jaro_similarity (const StringRef s1, const StringRef s2);
 
 // Computing similarity index between s1 and s2 using Jaro-Winkler algorithm,
 // which is an "adjusted" version of the Jaro one.
@@ -166,7 +177,7 @@ double jaro_similarity (const std::string& s1, const std::string& s2);
 //      https://en.wikipedia.org/wiki/Jaro-Winkler_distance
 // This routine computes jaro similarity (sj), and if sj>thresholds,
 // it performs the winkler adjustment, otherwise returns sj.
-double jaro_winkler_similarity (const std::string& s1, const std::string& s2,
+double jaro_winkler_similarity (const StringRef s1, const StringRef s2,
                                 const int l = 4,
                                 const double p = 0.1,
                                 const double threshold = 0.7);
@@ -185,6 +196,10 @@ double jaccard_similarity (const std::string& s1, const std::string& s2,
                            const bool tokenize_s1 = true,
                            const bool tokenize_s2 = true);
 
+// To find the best matches for a string among many candidates, rather
+// than calling the functions above on each of them, see SuggestionIndex
+// (in ekat_suggestion_index.hpp).
+
 // ==================== Case Insensitive string =================== //
 
 // A no-overhead class that inherits from std::string, which we only
@@ -200,10 +215,34 @@ public:
   virtual ~CaseInsensitiveString () = default;
 };
 
-// Case-insensitive comparison functions
-bool caseInsensitiveEqualString (const std::string& s1, const std::string& s2);
-bool caseInsensitiveLessString (const std::string& s1, const std::string& s2);
-bool caseInsensitiveLessEqualString (const std::string& s1, const std::string& s2);
+// Case-insensitive comparison functions. These compare chars one at a time,
+// without creating upper/lower case copies of the inputs.
+bool caseInsensitiveEqualString (const StringRef s1, const StringRef s2);
+bool caseInsensitiveLessString (const StringRef s1, const StringRef s2);
+bool caseInsensitiveLessEqualString (const StringRef s1, const StringRef s2);
+
+// Case-insensitive hash, consistent with caseInsensitiveEqualString
+// (i.e., strings that compare equal have the same hash).
+size_t caseInsensitiveHash (const StringRef s);
+
+// Function objects, to use case-insensitive keys in std containers, e.g.
+//   std::unordered_map<std::string,int,CaseInsensitiveHash,CaseInsensitiveEqual>
+//   std::map<std::string,int,CaseInsensitiveLess>
+// Note: CaseInsensitiveString can also be used directly as a key, since
+//       std::hash is specialized for it (see bottom of this file).
+struct CaseInsensitiveHash {
+  size_t operator() (const StringRef s) const { return caseInsensitiveHash(s); }
+};
+struct CaseInsensitiveEqual {
+  bool operator() (const StringRef s1, const StringRef s2) const {
+    return caseInsensitiveEqualString(s1,s2);
+  }
+};
+struct CaseInsensitiveLess {
+  bool operator() (const StringRef s1, const StringRef s2) const {
+    return caseInsensitiveLessString(s1,s2);
+  }
+};
 
 // Overloads of comparison operators, which use the routines above if at least one
 // of the two inputs is indeed a CaseInsensitiveString
@@ -245,4 +284,13 @@ operator<= (const S1& s1, const S2& s2) {
 
 } // namespace ekat
 
+namespace std {
+template<>
+struct hash<ekat::CaseInsensitiveString> {
+  size_t operator() (const ekat::CaseInsensitiveString& s) const {
+    return ekat::caseInsensitiveHash(s);
+  }
+};
+} // namespace std
+
 #endif // EKAT_STRING_UTILS_HPP
@@ -0,0 +1,123 @@
+#include "ekat/util/ekat_suggestion_index.hpp"
+#include "ekat/util/ekat_string_utils.hpp"
+
+#include <algorithm>
+#include <cctype>
+
+namespace ekat {
+
+namespace {
+// Number of candidates (per requested suggestion) to score with Jaro-Winkler
+constexpr int candidates_per_suggestion = 8;
+constexpr int min_candidates = 32;
+}
+
+std::string SuggestionIndex::lower (const StringRef s) {
+  std::string l(s.data(),s.size());
+  for (auto& c : l) {
+    c = std::tolower(static_cast<unsigned char>(c));
+  }
+  return l;
+}
+
+template<typename F>
+void SuggestionIndex::for_each_bigram (const StringRef s, F&& f) {
+  // Use '\0' as boundary marker, so that first/last chars get their own bigram
+  unsigned char prev = 0;
+  for (const char c : s) {
+    const unsigned char curr = static_cast<unsigned char>(c);
+    f(static_cast<bigram_t>((prev << 8) | curr));
+    prev = curr;
+  }
+  f(static_cast<bigram_t>(prev << 8));
+}
+
+void SuggestionIndex::add (const std::string& name) {
+  if (m_ids.count(name)>0) {
+    return;
+  }
+  const int id = m_names.size();
+  m_ids.emplace(name,id);
+  m_names.push_back(name);
+  m_lower_names.push_back(lower(name));
+
+  for_each_bigram(m_lower_names.back(),[&](const bigram_t b) {
+    auto& list = m_postings[b];
+    // A name may contain the same bigram more than once: store it once
+    if (list.empty() || list.back()!=id) {
+      list.push_back(id);
+    }
+  });
+}
+
+std::vector<std::string>
+SuggestionIndex::suggest (const std::string& s, const int k,
+                          const double min_similarity) const
+{
+  std::vector<std::string> result;
+  if (k<=0 || m_names.empty()) {
+    return result;
+  }
+  const auto ls = lower(s);
+
+  // 1. Count shared bigrams for each name sharing at least one with s
+  std::vector<bigram_t> bigrams;
+  for_each_bigram(ls,[&](const bigram_t b) { bigrams.push_back(b); });
+  std::sort(bigrams.begin(),bigrams.end());
+  bigrams.erase(std::unique(bigrams.begin(),bigrams.end()),bigrams.end());
+
+  std::vector<int> shared(m_names.size(),0);
+  std::vector<std::pair<int,int>> candidates;
+  for (const auto b : bigrams) {
+    auto it = m_postings.find(b);
+    if (it!=m_postings.end()) {
+      for (const int id : it->second) {
+        if (shared[id]++==0) {
+          candidates.emplace_back(id,0);
+        }
+      }
+    }
+  }
+  for (auto& c : candidates) {
+    c.second = shared[c.first];
+  }
+
+  // 2. Keep only the candidates sharing the most bigrams
+  const size_t ncand = std::min<size_t>(candidates.size(),
+                                        std::max(min_candidates,candidates_per_suggestion*k));
+  auto more_shared = [](const std::pair<int,int>& a, const std::pair<int,int>& b) {
+    return a.second>b.second || (a.second==b.second && a.first<b.first);
+  };
+  std::partial_sort(candidates.begin(),candidates.begin()+ncand,candidates.end(),more_shared);
+  candidates.resize(ncand);
+
+  // 3. Score the candidates, and keep the best k
+  std::vector<std::pair<double,int>> scored;
+  for (const auto& c : candidates) {
+    const double sim = jaro_winkler_similarity(ls,m_lower_names[c.first]);
+    if (sim>=min_similarity) {
+      scored.emplace_back(sim,c.first);
+    }
+  }
+  auto better = [](const std::pair<double,int>& a, const std::pair<double,int>& b) {
+    return a.first>b.first || (a.first==b.first && a.second<b.second);
+  };
+  const size_t nres = std::min<size_t>(scored.size(),k);
+  std::partial_sort(scored.begin(),scored.begin()+nres,scored.end(),better);
+  for (size_t i=0; i<nres; ++i) {
+    result.push_back(m_names[scored[i].second]);
+  }
+  return result;
+}
+
+std::string SuggestionIndex::did_you_mean (const std::string& s, const int k,
+                                           const double min_similarity) const
+{
+  const auto matches = suggest(s,k,min_similarity);
+  if (matches.empty()) {
+    return "";
+  }
+  return "Did you mean " + join(matches,[](const std::string& m) { return "'" + m + "'"; }, ", ") + "?";
+}
+
+} // namespace ekat
@@ -0,0 +1,71 @@
+#ifndef EKAT_SUGGESTION_INDEX_HPP
+#define EKAT_SUGGESTION_INDEX_HPP
+
+#include "ekat/util/ekat_string_ref.hpp"
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace ekat {
+
+/*
+ * An index over a set of names, to quickly find the ones most similar to
+ * a given (possibly misspelled) string, e.g., to provide feedback like
+ * "key 'balh' not found; did you mean 'blah'?".
+ *
+ * Names are indexed by their character bigrams (with the string boundaries
+ * as extra chars), in an inverted list. A query first ranks names by the
+ * number of bigrams they share with the input, and then computes the
+ * Jaro-Winkler similarity only for the best candidates, rather than for
+ * all names. Comparisons are case insensitive.
+ *
+ * Note: the candidate pruning is a heuristic. A name sharing very few
+ *       bigrams with the input may be discarded even if its Jaro-Winkler
+ *       similarity would have been above the threshold.
+ */
+
+class SuggestionIndex {
+public:
+  SuggestionIndex () = default;
+
+  template<typename Iterable>
+  explicit SuggestionIndex (const Iterable& names) {
+    for (const auto& n : names) {
+      add(n);
+    }
+  }
+
+  // Add a name to the index (duplicates are ignored)
+  void add (const std::string& name);
+
+  size_t size () const { return m_names.size(); }
+
+  // Return (up to) k names with the highest Jaro-Winkler similarity with s,
+  // among those with similarity at least min_similarity, best match first.
+  std::vector<std::string> suggest (const std::string& s, const int k = 3,
+                                    const double min_similarity = 0.7) const;
+
+  // Format the result of suggest as "Did you mean 'a', 'b'?", or return an
+  // empty string if there are no suggestions.
+  std::string did_you_mean (const std::string& s, const int k = 3,
+                            const double min_similarity = 0.7) const;
+
+private:
+  using bigram_t = std::uint16_t;
+
+  static std::string lower (const StringRef s);
+
+  template<typename F>
+  static void for_each_bigram (const StringRef s, F&& f);
+
+  std::vector<std::string>                          m_names;
+  std::vector<std::string>                          m_lower_names;
+  std::unordered_map<std::string,int>               m_ids;
+  std::unordered_map<bigram_t,std::vector<int>>     m_postings;
+};
+
+} // namespace ekat
+
+#endif // EKAT_SUGGESTION_INDEX_HPP
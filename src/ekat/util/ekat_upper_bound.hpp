@@ -2,6 +2,7 @@
 #define EKAT_UPPER_BOUND_HPP
 
 #include "ekat/ekat.hpp"
+#include "ekat/ekat_pack.hpp"
 
 #ifndef EKAT_ENABLE_GPU
 # include <algorithm>
@@ -58,6 +59,47 @@ const T* upper_bound(const T* first, const T* last, const T& value)
 using std::upper_bound;
 #endif
 
+/*
+ * Pack version of upper_bound: runs Pack::n binary searches in lockstep over
+ * the sorted range [first,last), one for each slot of value, and returns the
+ * offsets from first of the upper bounds (i.e., result[s] is the same as
+ * std::upper_bound(first,last,value[s])-first).
+ *
+ * Unlike upper_bound_impl above, the search keeps the size of the remaining
+ * range independent of the comparison outcome, so that all slots take the
+ * same number of steps (ceil(log2(last-first))+1), and each step is a gather
+ * followed by a masked update of the index pack.
+ */
+template<typename T, int N>
+KOKKOS_INLINE_FUNCTION
+Pack<int,N> upper_bound(T* first, T* last,
+                        const Pack<typename std::remove_const<T>::type,N>& value)
+{
+  Pack<int,N> base(0);
+  int count = last - first;
+  if (count == 0) {
+    return base;
+  }
+
+  Pack<typename std::remove_const<T>::type,N> pivot;
+  while (count > 1) {
+    const int half = count / 2;
+    vector_simd for (int s = 0; s < N; ++s) {
+      pivot[s] = first[base[s] + half];
+    }
+    // Note: use !(value<pivot) rather than value>=pivot, to match the
+    //       behavior of std::upper_bound in case of NaNs.
+    base.set(!(value < pivot), base + half);
+    count -= half;
+  }
+
+  vector_simd for (int s = 0; s < N; ++s) {
+    pivot[s] = first[base[s]];
+  }
+  base.set(!(value < pivot), base + 1);
+  return base;
+}
+
 } // namespace ekat
 
 #endif // EKAT_UPPER_BOUND_HPP
@@ -1,10 +1,16 @@
 #include <catch2/catch.hpp>
 
 #include "ekat/io/ekat_yaml.hpp"
+#include "ekat/io/ekat_parameter_list_serialization.hpp"
 #include "ekat/util/ekat_string_utils.hpp"
 
+#include <clocale>
+#include <cstdio>
+#include <ctime>
 #include <fstream>
 
+#include <utime.h>
+
 namespace {
 
 TEST_CASE ("yaml_parser","") {
@@ -67,10 +73,77 @@ TEST_CASE ("yaml_parser","") {
 
 }
 
+TEST_CASE ("yaml_scalar_types") {
+  using namespace ekat;
+  Comm comm(MPI_COMM_WORLD);
+
+  // Each rank uses its own file, to avoid races
+  const std::string fname = "scalars_" + std::to_string(comm.rank()) + ".yaml";
+  {
+    std::ofstream ofs(fname);
+    ofs << "b1: True\n"
+        << "b2: FALSE\n"
+        << "i1: -12\n"
+        << "i2: +7\n"
+        << "i3: 3000000000\n"      // too large for int
+        << "d1: 1.5e3\n"
+        << "d2: .25\n"
+        << "d3: 1e-2\n"
+        << "d4: !!float 4\n"
+        << "s1: 0x10\n"            // no hex
+        << "s2: nan\n"             // no nan/inf
+        << "s3: 1e\n"
+        << "s4: 12abc\n"
+        << "s5: !!str 12\n"
+        << "v1: [True, false]\n"
+        << "v2: [1, -2]\n"
+        << "v3: [1, 2.5]\n"
+        << "v4: [1, true]\n"
+        << "v5: !floats [1, 2]\n";
+  }
+
+  ParameterList params("parameters");
+  parse_yaml_file(fname,params);
+
+  REQUIRE (params.get<bool>("b1")==true);
+  REQUIRE (params.get<bool>("b2")==false);
+  REQUIRE (params.get<int>("i1")==-12);
+  REQUIRE (params.get<int>("i2")==7);
+  REQUIRE (params.get<double>("i3")==3e9);
+  REQUIRE (params.get<double>("d1")==1.5e3);
+  REQUIRE (params.get<double>("d2")==0.25);
+  REQUIRE (params.get<double>("d3")==1e-2);
+  REQUIRE (params.get<double>("d4")==4.0);
+  for (auto n : {"s1","s2","s3","s4","s5"}) {
+    REQUIRE (params.isType<std::string>(n));
+  }
+  REQUIRE (params.get<std::vector<char>>("v1")==std::vector<char>{1,0});
+  REQUIRE (params.get<std::vector<int>>("v2")==std::vector<int>{1,-2});
+  REQUIRE (params.get<std::vector<double>>("v3")==std::vector<double>{1,2.5});
+  REQUIRE (params.get<std::vector<std::string>>("v4")==std::vector<std::string>{"1","true"});
+  REQUIRE (params.get<std::vector<double>>("v5")==std::vector<double>{1,2});
+
+  // Parsing does not depend on the global locale (e.g., with a decimal comma)
+  for (auto loc : {"de_DE.UTF-8","de_DE.utf8","fr_FR.UTF-8","it_IT.UTF-8"}) {
+    const std::string old_loc = std::setlocale(LC_NUMERIC,nullptr);
+    if (std::setlocale(LC_NUMERIC,loc)!=nullptr) {
+      ParameterList params_loc("parameters");
+      parse_yaml_file(fname,params_loc);
+      std::setlocale(LC_NUMERIC,old_loc.c_str());
+      REQUIRE (params_loc.get<double>("d1")==1.5e3);
+      REQUIRE (params_loc.get<double>("d2")==0.25);
+      REQUIRE (params_loc.get<std::vector<double>>("v3")==std::vector<double>{1,2.5});
+      break;
+    }
+  }
+}
+
 TEST_CASE ("write_yaml") {
   using namespace ekat;
+  // Each rank writes its own file, to avoid races
+  Comm comm(MPI_COMM_WORLD);
   std::string ifile = "input.yaml";
-  std::string ofile = "output.yaml";
+  std::string ofile = "output_" + std::to_string(comm.rank()) + ".yaml";
 
   ParameterList params1("parameters"),params2("parameters");
 
@@ -94,4 +167,167 @@ TEST_CASE ("write_yaml") {
   }
 }
 
+TEST_CASE ("serialize_parameter_list") {
+  using namespace ekat;
+
+  ParameterList params("parameters");
+  parse_yaml_file("input.yaml",params);
+
+  // Round trip must preserve names, types, and values
+  auto buffer = serialize_parameter_list(params);
+  auto copy = deserialize_parameter_list(buffer);
+
+  std::stringstream ss1,ss2;
+  params.print(ss1);
+  copy.print(ss2);
+  REQUIRE (ss1.str()==ss2.str());
+  REQUIRE (copy.sublist("Options").isType<bool>("My Bool"));
+  REQUIRE (copy.sublist("Constants").isType<std::vector<char>>("Two Logicals"));
+
+  // Corrupted/truncated buffers are detected
+  REQUIRE_THROWS (deserialize_parameter_list(buffer.data(),buffer.size()-1));
+  buffer[0] = 'X';
+  REQUIRE_THROWS (deserialize_parameter_list(buffer));
+
+  // Content hash does not depend on insertion order, but does depend on values
+  ParameterList pl1("pl"), pl2("pl");
+  pl1.set("a",1);
+  pl1.set("b",std::string("two"));
+  pl1.sublist("s").set("c",3.0);
+  pl2.sublist("s").set("c",3.0);
+  pl2.set("b",std::string("two"));
+  pl2.set("a",1);
+  REQUIRE (parameter_list_hash(pl1)==parameter_list_hash(pl2));
+  pl2.set("a",2);
+  REQUIRE (parameter_list_hash(pl1)!=parameter_list_hash(pl2));
+
+  // Sublists are restored under their key, even if their name differs
+  ParameterList pl3("pl");
+  pl3.sublist("s1").rename("s");
+  pl3.sublist("s1").set("a",1);
+  pl3.sublist("s2").rename("s");
+  pl3.sublist("s2").set("a",2);
+  auto pl3_copy = deserialize_parameter_list(serialize_parameter_list(pl3));
+  REQUIRE (not pl3_copy.isSublist("s"));
+  REQUIRE (pl3_copy.sublist("s1").name()=="s");
+  REQUIRE (pl3_copy.sublist("s1").get<int>("a")==1);
+  REQUIRE (pl3_copy.sublist("s2").name()=="s");
+  REQUIRE (pl3_copy.sublist("s2").get<int>("a")==2);
+
+  // Binary files
+  Comm comm(MPI_COMM_WORLD);
+  const std::string bfile = "params_" + std::to_string(comm.rank()) + ".bin";
+  write_parameter_list_binary(bfile,params);
+  REQUIRE (parameter_list_hash(read_parameter_list_binary(bfile))==parameter_list_hash(params));
+
+  // Unsupported types cannot be serialized
+  params.set("unsupported",1.0f);
+  REQUIRE_THROWS (serialize_parameter_list(params));
+}
+
+TEST_CASE ("yaml_parser_cached") {
+  using namespace ekat;
+  Comm comm(MPI_COMM_WORLD);
+
+  // Each rank uses its own files, to avoid races
+  const std::string yfile = "cached_" + std::to_string(comm.rank()) + ".yaml";
+  const std::string cfile = yfile + ".cache";
+  std::remove(cfile.c_str());
+
+  auto write_yaml = [&](const int val) {
+    std::ofstream ofs(yfile);
+    ofs << "my_int: " << val << "\n"
+        << "my_list:\n"
+        << "  my_string: hello\n";
+  };
+
+  write_yaml(1);
+  ParameterList params("parameters");
+  parse_yaml_file_cached(yfile,params);
+  REQUIRE (std::ifstream(cfile).good());
+  REQUIRE (params.get<int>("my_int")==1);
+
+  // Loading from the cache gives the same list (and the caller's name)
+  ParameterList cached("other");
+  parse_yaml_file_cached(yfile,cached);
+  REQUIRE (cached.name()=="other");
+  REQUIRE (parameter_list_hash(cached.sublist("my_list"))==parameter_list_hash(params.sublist("my_list")));
+  REQUIRE (cached.get<int>("my_int")==1);
+
+  // A change in the yaml file (even with same size and mtime) invalidates the cache
+  write_yaml(2);
+  parse_yaml_file_cached(yfile,params);
+  REQUIRE (params.get<int>("my_int")==2);
+
+  // A corrupted cache is ignored
+  {
+    std::ofstream ofs(cfile,std::ios::binary);
+    ofs << "garbage";
+  }
+  parse_yaml_file_cached(yfile,params);
+  REQUIRE (params.get<int>("my_int")==2);
+
+  // If the yaml file is older than the cache, mtime and size are enough to
+  // validate the cache, so the yaml file is not even read
+  auto set_mtime = [&](const std::time_t t) {
+    utimbuf times;
+    times.actime = times.modtime = t;
+    REQUIRE (utime(yfile.c_str(),&times)==0);
+  };
+  const auto past = std::time(nullptr) - 100;
+  set_mtime(past);
+  std::remove(cfile.c_str());
+  parse_yaml_file_cached(yfile,params);
+  write_yaml(3);
+  set_mtime(past);
+  parse_yaml_file_cached(yfile,params);
+  REQUIRE (params.get<int>("my_int")==2);
+
+  // A different mtime triggers a content check
+  set_mtime(past+1);
+  parse_yaml_file_cached(yfile,params);
+  REQUIRE (params.get<int>("my_int")==3);
+  std::remove(cfile.c_str());
+}
+
+TEST_CASE ("yaml_parser_cached_collective") {
+  using namespace ekat;
+  Comm comm(MPI_COMM_WORLD);
+
+  // All ranks use the same files, but only root accesses the cache
+  const std::string cfile = "input.yaml.collective.cache";
+  if (comm.am_i_root()) {
+    std::remove(cfile.c_str());
+  }
+  comm.barrier();
+
+  ParameterList local("parameters");
+  parse_yaml_file("input.yaml",local);
+  for (int i=0; i<2; ++i) {
+    ParameterList params("parameters");
+    parse_yaml_file_cached("input.yaml",params,comm,cfile);
+    REQUIRE (parameter_list_hash(params)==parameter_list_hash(local));
+    REQUIRE (std::ifstream(cfile).good());
+  }
+
+  REQUIRE_THROWS (parse_yaml_file_cached("not_a_file.yaml",comm));
+}
+
+TEST_CASE ("yaml_parser_collective") {
+  using namespace ekat;
+  Comm comm(MPI_COMM_WORLD);
+
+  ParameterList local("parameters"), bcast("parameters");
+  parse_yaml_file("input.yaml",local);
+  parse_yaml_file("input.yaml",bcast,comm);
+
+  std::stringstream ss1,ss2;
+  local.print(ss1);
+  bcast.print(ss2);
+  REQUIRE (ss1.str()==ss2.str());
+
+  // Failure on root must be reported on all ranks (and not hang)
+  REQUIRE_THROWS (parse_yaml_file("not_a_file.yaml",comm));
+}
+
 } // anonymous namespace
@@ -1,6 +1,9 @@
 #include <catch2/catch.hpp>
 #include "ekat/mpi/ekat_comm.hpp"
 
+#include <algorithm>
+#include <vector>
+
 // Instantiate get_mpi_type for a user defined type
 // to check that the user can extend comm functionalities
 // to new types
@@ -115,6 +118,225 @@ void test_gather_in_place (const ekat::Comm& comm) {
   delete[] ranks;
 }
 
+// In the v-collectives tests, rank r owns r+1 entries, with values 100*r+i
+template<typename T>
+T vval (const int r, const int i) { return T(100*r+i); }
+
+template<typename T>
+void test_gatherv (const ekat::Comm& comm) {
+  const int rank = comm.rank();
+  const int size = comm.size();
+  const int my_count = rank+1;
+
+  auto counts = comm.all_gather_counts(my_count);
+  REQUIRE (counts.total()==size*(size+1)/2);
+
+  std::vector<T> mine(my_count), all(counts.total());
+  for (int i=0; i<my_count; ++i) {
+    mine[i] = vval<T>(rank,i);
+  }
+
+  auto check_all = [&](const std::vector<T>& v) {
+    for (int r=0; r<size; ++r) {
+      for (int i=0; i<r+1; ++i) {
+        REQUIRE (v[counts.displs[r]+i]==vval<T>(r,i));
+      }
+    }
+  };
+
+  for (int root=0; root<size; ++root) {
+    std::fill(all.begin(),all.end(),T(-1));
+    comm.gatherv(mine.data(),my_count,all.data(),counts,root);
+    if (rank==root) {
+      check_all(all);
+    }
+  }
+
+  std::fill(all.begin(),all.end(),T(-1));
+  comm.all_gatherv(mine.data(),my_count,all.data(),counts);
+  check_all(all);
+
+  // In place: my entries are already at my displacement
+  const int root = size-1;
+  std::fill(all.begin(),all.end(),T(-1));
+  std::copy(mine.begin(),mine.end(),all.begin()+counts.displs[rank]);
+  comm.gatherv(all.data(),counts,root);
+  if (rank==root) {
+    check_all(all);
+  }
+
+  std::fill(all.begin(),all.end(),T(-1));
+  std::copy(mine.begin(),mine.end(),all.begin()+counts.displs[rank]);
+  comm.all_gatherv(all.data(),counts);
+  check_all(all);
+
+  // Non-contiguous displacements, with a gap of one entry between ranks
+  ekat::CommCounts gaps = counts;
+  for (int r=0; r<size; ++r) {
+    gaps.displs[r] += r;
+  }
+  REQUIRE (gaps.total()==counts.total()+size-1);
+  std::vector<T> all_gaps(gaps.total(),T(-1));
+  comm.all_gatherv(mine.data(),my_count,all_gaps.data(),gaps);
+  for (int r=0; r<size; ++r) {
+    for (int i=0; i<r+1; ++i) {
+      REQUIRE (all_gaps[gaps.displs[r]+i]==vval<T>(r,i));
+    }
+    if (r>0) {
+      REQUIRE (all_gaps[gaps.displs[r]-1]==T(-1));
+    }
+  }
+}
+
+template<typename T>
+void test_scatterv (const ekat::Comm& comm) {
+  const int rank = comm.rank();
+  const int size = comm.size();
+  const int my_count = rank+1;
+
+  auto counts = comm.all_gather_counts(my_count);
+  std::vector<T> all(counts.total());
+  for (int r=0; r<size; ++r) {
+    for (int i=0; i<r+1; ++i) {
+      all[counts.displs[r]+i] = vval<T>(r,i);
+    }
+  }
+
+  for (int root=0; root<size; ++root) {
+    std::vector<T> mine(my_count,T(-1));
+    comm.scatterv(all.data(),counts,mine.data(),my_count,root);
+    for (int i=0; i<my_count; ++i) {
+      REQUIRE (mine[i]==vval<T>(rank,i));
+    }
+  }
+
+  // In place: I receive my entries at my displacement
+  const int root = 0;
+  std::vector<T> inplace(counts.total(),T(-1));
+  if (rank==root) {
+    inplace = all;
+  }
+  comm.scatterv(inplace.data(),counts,root);
+  for (int i=0; i<my_count; ++i) {
+    REQUIRE (inplace[counts.displs[rank]+i]==vval<T>(rank,i));
+  }
+}
+
+template<typename T>
+void test_all_to_allv (const ekat::Comm& comm) {
+  const int rank = comm.rank();
+  const int size = comm.size();
+
+  // Send r+1 entries to rank r, with values 100*rank+r
+  std::vector<int> sc(size);
+  for (int r=0; r<size; ++r) {
+    sc[r] = r+1;
+  }
+  ekat::CommCounts send_counts(sc);
+  auto recv_counts = comm.all_to_all_counts(send_counts);
+  for (int r=0; r<size; ++r) {
+    REQUIRE (recv_counts.counts[r]==rank+1);
+  }
+
+  std::vector<T> send(send_counts.total()), recv(recv_counts.total(),T(-1));
+  for (int r=0; r<size; ++r) {
+    for (int i=0; i<sc[r]; ++i) {
+      send[send_counts.displs[r]+i] = vval<T>(rank,r);
+    }
+  }
+  comm.all_to_allv(send.data(),send_counts,recv.data(),recv_counts);
+  for (int r=0; r<size; ++r) {
+    for (int i=0; i<rank+1; ++i) {
+      REQUIRE (recv[recv_counts.displs[r]+i]==vval<T>(r,rank));
+    }
+  }
+
+  // In place, exchanging 2 entries with every rank
+  ekat::CommCounts counts(std::vector<int>(size,2));
+  std::vector<T> vals(counts.total());
+  for (int r=0; r<size; ++r) {
+    vals[2*r]   = vval<T>(rank,r);
+    vals[2*r+1] = vval<T>(rank,r+size);
+  }
+  comm.all_to_allv(vals.data(),counts);
+  for (int r=0; r<size; ++r) {
+    REQUIRE (vals[2*r]  ==vval<T>(r,rank));
+    REQUIRE (vals[2*r+1]==vval<T>(r,rank+size));
+  }
+}
+
+template<typename T>
+void test_nonblocking (const ekat::Comm& comm) {
+  const int rank = comm.rank();
+  const int size = comm.size();
+
+  // Post all the operations, then wait on them together
+  std::vector<T> bcast(size), gather(size), gather_in_place(size);
+  T val = rank;
+  T sum, sum_in_place = rank, scan, scan_in_place = rank;
+  for (int i=0; i<size; ++i) {
+    bcast[i] = -rank;
+  }
+  gather_in_place[rank] = rank;
+
+  std::vector<ekat::CommRequest> reqs;
+  for (int i=0; i<size; ++i) {
+    reqs.push_back(comm.ibroadcast(&bcast[i],1,i));
+  }
+  reqs.push_back(comm.iall_reduce(&val,&sum,1,MPI_SUM));
+  reqs.push_back(comm.iall_reduce(&sum_in_place,1,MPI_SUM));
+  reqs.push_back(comm.iscan(&val,&scan,1,MPI_SUM));
+  reqs.push_back(comm.iscan(&scan_in_place,1,MPI_SUM));
+  reqs.push_back(comm.iall_gather(&val,gather.data(),1));
+  reqs.push_back(comm.iall_gather(gather_in_place.data(),1));
+  ekat::wait_all(reqs);
+
+  // Completed requests remain completed
+  for (auto& r : reqs) {
+    REQUIRE (r.test());
+  }
+
+  const T sum_gauss = T((size-1)*size)/2;
+  const T scan_gauss = T(rank*(rank+1))/2;
+  REQUIRE (sum==sum_gauss);
+  REQUIRE (sum_in_place==sum_gauss);
+  REQUIRE (scan==scan_gauss);
+  REQUIRE (scan_in_place==scan_gauss);
+  for (int i=0; i<size; ++i) {
+    REQUIRE (bcast[i]==T(-i));
+    REQUIRE (gather[i]==T(i));
+    REQUIRE (gather_in_place[i]==T(i));
+  }
+
+  // Single requests, completed via wait/test or via the destructor
+  T red = rank;
+  auto req = comm.iall_reduce(&red,1,MPI_MAX);
+  while (not req.test()) {}
+  REQUIRE (red==T(size-1));
+
+  T bval = rank==0 ? T(42) : T(0);
+  {
+    auto r = comm.ibroadcast(&bval,1,0);
+  }
+  REQUIRE (bval==T(42));
+
+  T v1 = rank, v2 = rank;
+  auto r1 = comm.iall_reduce(&v1,1,MPI_MIN);
+  auto r2 = comm.iall_reduce(&v2,1,MPI_MAX);
+  ekat::wait_all(r1,r2);
+  REQUIRE (v1==T(0));
+  REQUIRE (v2==T(size-1));
+
+  // Moving a request transfers ownership of the pending operation
+  T v3 = rank;
+  ekat::CommRequest r3;
+  REQUIRE (r3.test());
+  r3 = comm.iall_reduce(&v3,1,MPI_SUM);
+  ekat::CommRequest r4(std::move(r3));
+  r4.wait();
+  REQUIRE (v3==sum_gauss);
+}
+
 TEST_CASE ("ekat_comm","") {
   using namespace ekat;
 
@@ -203,6 +425,71 @@ TEST_CASE ("ekat_comm","") {
     test_gather_in_place<TwoInts>(comm);
   }
 
+  SECTION ("gatherv") {
+    test_gatherv<int>(comm);
+    test_gatherv<double>(comm);
+    test_gatherv<TwoInts>(comm);
+
+    std::vector<int> all(size+1);
+    REQUIRE_THROWS (comm.all_gatherv(&rank,1,all.data(),CommCounts(std::vector<int>(size+1,1))));
+  }
+
+  SECTION ("scatterv") {
+    test_scatterv<int>(comm);
+    test_scatterv<double>(comm);
+  }
+
+  SECTION ("all_to_allv") {
+    test_all_to_allv<int>(comm);
+    test_all_to_allv<double>(comm);
+  }
+
+  SECTION ("nonblocking") {
+    test_nonblocking<int>(comm);
+    test_nonblocking<long long>(comm);
+    test_nonblocking<double>(comm);
+  }
+
+  SECTION ("hierarchical") {
+    Comm hcomm(MPI_COMM_WORLD);
+    REQUIRE (hcomm.get_collective_mode()==Comm::CollectiveMode::Flat);
+    hcomm.set_collective_mode(Comm::CollectiveMode::Hierarchical);
+    REQUIRE (hcomm.get_collective_mode()==Comm::CollectiveMode::Hierarchical);
+
+    // Copies share the mode (and the node comms)
+    const auto hcopy = hcomm;
+    REQUIRE (hcopy.get_collective_mode()==Comm::CollectiveMode::Hierarchical);
+
+    for (const auto& c : {hcomm,hcopy}) {
+      test_broadcast<char>(c);
+      test_broadcast<int>(c);
+      test_broadcast<double>(c);
+
+      const int sum_gauss = (size-1)*size/2;
+      test_reduce<int>(c,rank,sum_gauss,MPI_SUM);
+      test_reduce<double>(c,rank,sum_gauss,MPI_SUM);
+      test_reduce<int>(c,rank,size-1,MPI_MAX);
+      test_reduce<int>(c,rank,0,MPI_MIN);
+      test_reduce_in_place<int>(c,rank,sum_gauss,MPI_SUM);
+      test_reduce_in_place<double>(c,rank,sum_gauss,MPI_SUM);
+      test_reduce_in_place<long long>(c,rank,size-1,MPI_MAX);
+    }
+
+    // Multiple entries
+    std::vector<int> vals(5), sums(5);
+    for (int i=0; i<5; ++i) {
+      vals[i] = rank*i;
+    }
+    hcomm.all_reduce(vals.data(),sums.data(),5,MPI_SUM);
+    for (int i=0; i<5; ++i) {
+      REQUIRE (sums[i]==i*(size-1)*size/2);
+    }
+
+    hcomm.set_collective_mode(Comm::CollectiveMode::Flat);
+    test_broadcast<int>(hcomm);
+    test_reduce<int>(hcomm,rank,(size-1)*size/2,MPI_SUM);
+  }
+
   SECTION ("split") {
     auto new_comm = comm.split(rank % 2);
     
@@ -229,6 +516,93 @@ TEST_CASE ("ekat_comm","") {
 
     delete[] ranks;
   }
+
+  SECTION ("split_ownership") {
+    REQUIRE (not comm.owns_mpi_comm());
+
+    // Use an attribute delete callback to detect when the MPI_Comm is freed
+    static bool freed;
+    freed = false;
+    auto on_free = [](MPI_Comm, int, void*, void*) -> int {
+      freed = true;
+      return MPI_SUCCESS;
+    };
+    int keyval;
+    MPI_Comm_create_keyval(MPI_COMM_NULL_COPY_FN,on_free,&keyval,nullptr);
+    {
+      // Split comms are owned only on request
+      auto c1 = comm.split(rank % 2);
+      REQUIRE (not c1.owns_mpi_comm());
+      c1.own_mpi_comm();
+      REQUIRE (c1.owns_mpi_comm());
+      MPI_Comm_set_attr(c1.mpi_comm(),keyval,nullptr);
+      {
+        auto c2 = c1;
+        REQUIRE (c2.owns_mpi_comm());
+      }
+      REQUIRE (not freed);
+
+      // A Comm wrapping the same MPI_Comm does not own it
+      Comm c3(c1.mpi_comm());
+      REQUIRE (not c3.owns_mpi_comm());
+    }
+    REQUIRE (freed);
+    MPI_Comm_free_keyval(&keyval);
+
+    // The MPI_Comm of a temporary split is still valid
+    MPI_Comm raw = comm.split(0).mpi_comm();
+    int raw_size;
+    MPI_Comm_size(raw,&raw_size);
+    REQUIRE (raw_size==size);
+    MPI_Comm_free(&raw);
+
+    auto node = comm.split_shared();
+    auto leaders = comm.split_node_leaders();
+    REQUIRE (not node.owns_mpi_comm());
+    REQUIRE (not leaders.owns_mpi_comm());
+    node.own_mpi_comm();
+    leaders.own_mpi_comm();
+
+    // Predefined comms cannot be owned
+    REQUIRE_THROWS (comm.own_mpi_comm());
+  }
+
+  SECTION ("cached_split") {
+    const auto c1 = comm.cached_split(0);
+    REQUIRE (c1.size()==size);
+    REQUIRE (c1.owns_mpi_comm());
+
+    // Same colors/keys on all ranks: the same comm is returned
+    REQUIRE (comm.cached_split(0).mpi_comm()==c1.mpi_comm());
+    REQUIRE (comm.cached_split(0,rank).mpi_comm()==c1.mpi_comm());
+
+    // Copies of a comm share the cache
+    Comm copy = comm;
+    REQUIRE (copy.cached_split(0).mpi_comm()==c1.mpi_comm());
+
+    // Rank 0 passes the same color/key as before, but the other ranks do not,
+    // so the partition is different, and a new comm is needed.
+    const auto c2 = comm.cached_split(rank % 2);
+    REQUIRE (c2.size()==(rank%2==0 ? (size+1)/2 : size/2));
+    if (size>1) {
+      REQUIRE (c2.mpi_comm()!=c1.mpi_comm());
+    }
+
+    // A different key ordering gives a different comm
+    const auto c3 = comm.cached_split(0,size-rank);
+    REQUIRE (c3.rank()==size-1-rank);
+    REQUIRE (comm.cached_split(0,size-rank).mpi_comm()==c3.mpi_comm());
+
+    // After clearing the cache, new comms are created
+    comm.clear_split_cache();
+    const auto c4 = comm.cached_split(0,size-rank);
+    REQUIRE (c4.mpi_comm()!=c3.mpi_comm());
+    REQUIRE (c4.rank()==size-1-rank);
+
+    // The cache of a new Comm is empty
+    Comm other(MPI_COMM_WORLD);
+    REQUIRE (other.cached_split(0,size-rank).mpi_comm()!=c4.mpi_comm());
+  }
 }
 
 } // anonymous namespace
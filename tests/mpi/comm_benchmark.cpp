@@ -0,0 +1,124 @@
+#include <catch2/catch.hpp>
+#include "ekat/mpi/ekat_comm.hpp"
+#include "ekat/mpi/ekat_reproducible_sum.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+namespace {
+
+// Compare flat and hierarchical all_reduce/broadcast, for small messages.
+// This is meant to run on a single node with many ranks, where MPI's choice
+// of algorithm for small messages is not always the best one.
+
+using Mode = ekat::Comm::CollectiveMode;
+
+template<typename F>
+double time_it (const ekat::Comm& comm, const int nreps, const F& f) {
+  // Warm up, and make sure all ranks start together
+  f();
+  comm.barrier();
+
+  const auto start = std::chrono::steady_clock::now();
+  for (int i=0; i<nreps; ++i) {
+    f();
+  }
+  const auto stop = std::chrono::steady_clock::now();
+
+  // Report the slowest rank, per call
+  double us = std::chrono::duration_cast<std::chrono::nanoseconds>(stop-start).count()*1e-3/nreps;
+  ekat::Comm flat(comm.mpi_comm());
+  flat.all_reduce(&us,1,MPI_MAX);
+  return us;
+}
+
+TEST_CASE ("hierarchical_collectives_benchmark") {
+  using namespace ekat;
+
+  Comm flat(MPI_COMM_WORLD);
+  Comm hier(MPI_COMM_WORLD);
+  hier.set_collective_mode(Mode::Hierarchical);
+
+  const int nreps = 1000;
+  const int rank = flat.rank();
+  const int size = flat.size();
+
+  if (flat.am_i_root()) {
+    std::cout << "  Flat vs hierarchical collectives on " << size << " ranks"
+              << " (us per call, max over ranks)\n"
+              << "    op          count      flat      hier\n";
+  }
+
+  for (int count : {1, 8, 64, 512}) {
+    std::vector<double> src(count,rank), dst(count);
+
+    double t_flat = time_it(flat,nreps,[&](){ flat.all_reduce(src.data(),dst.data(),count,MPI_SUM); });
+    double t_hier = time_it(hier,nreps,[&](){ hier.all_reduce(src.data(),dst.data(),count,MPI_SUM); });
+
+    // Integer-valued sums are exact, regardless of the reduction order
+    for (int i=0; i<count; ++i) {
+      REQUIRE (dst[i]==0.5*(size-1)*size);
+    }
+
+    if (flat.am_i_root()) {
+      std::cout << "    all_reduce " << std::setw(6) << count
+                << std::fixed << std::setprecision(2)
+                << std::setw(10) << t_flat << std::setw(10) << t_hier << "\n";
+    }
+
+    const int root = size-1;
+    t_flat = time_it(flat,nreps,[&](){ flat.broadcast(dst.data(),count,root); });
+    t_hier = time_it(hier,nreps,[&](){ hier.broadcast(dst.data(),count,root); });
+
+    if (flat.am_i_root()) {
+      std::cout << "    broadcast  " << std::setw(6) << count
+                << std::fixed << std::setprecision(2)
+                << std::setw(10) << t_flat << std::setw(10) << t_hier << "\n";
+    }
+  }
+}
+
+TEST_CASE ("reproducible_sum_benchmark") {
+  using namespace ekat;
+
+  Comm comm(MPI_COMM_WORLD);
+  const int rank = comm.rank();
+
+  // Global sum of n values per rank, with a plain all_reduce and a reproducible sum
+  const int nreps = 10;
+  for (int n : {1000, 100000, 1000000}) {
+    std::vector<double> vals(n);
+    for (int i=0; i<n; ++i) {
+      vals[i] = 1.0/(1+i+rank);
+    }
+
+    double plain, repro;
+    const double t_plain = time_it(comm,nreps,[&](){
+      plain = 0;
+      for (auto v : vals) {
+        plain += v;
+      }
+      comm.all_reduce(&plain,1,MPI_SUM);
+    });
+    const double t_repro = time_it(comm,nreps,[&](){
+      repro = reproducible_sum(comm,vals.data(),n);
+    });
+
+    // The two sums differ at most by rounding errors
+    REQUIRE (std::abs(plain-repro)<=1e-12*std::abs(repro));
+
+    if (comm.am_i_root()) {
+      std::cout << "  Global sum of " << n << " values per rank on " << comm.size() << " ranks:\n"
+                << std::fixed << std::setprecision(2)
+                << "    all_reduce:       " << std::setw(10) << t_plain << " us ("
+                << n/t_plain << " Mvals/s per rank)\n"
+                << "    reproducible_sum: " << std::setw(10) << t_repro << " us ("
+                << n/t_repro << " Mvals/s per rank)\n";
+    }
+  }
+}
+
+} // anonymous namespace
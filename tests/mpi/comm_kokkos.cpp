@@ -0,0 +1,158 @@
+#include <catch2/catch.hpp>
+
+#include "ekat/mpi/ekat_comm_kokkos.hpp"
+#include "ekat/kokkos/ekat_kokkos_types.hpp"
+
+#include <vector>
+
+namespace {
+
+using PackT = ekat::Pack<double,4>;
+
+TEST_CASE ("pack_collectives") {
+  using namespace ekat;
+
+  Comm comm(MPI_COMM_WORLD);
+  const int rank = comm.rank();
+  const int size = comm.size();
+  const int n = 3;
+  constexpr int N = PackT::n;
+
+  std::vector<PackT> mine(n), all(n*size);
+  for (int i=0; i<n; ++i) {
+    for (int k=0; k<N; ++k) {
+      mine[i][k] = rank*100 + i*N + k;
+    }
+  }
+
+  SECTION ("broadcast") {
+    auto vals = mine;
+    comm.broadcast(vals.data(),n,size-1);
+    for (int i=0; i<n; ++i) {
+      for (int k=0; k<N; ++k) {
+        REQUIRE (vals[i][k]==(size-1)*100 + i*N + k);
+      }
+    }
+  }
+
+  SECTION ("all_reduce") {
+    // Packs are reduced entry-wise
+    std::vector<PackT> sum(n), max(n);
+    comm.all_reduce(mine.data(),sum.data(),n,MPI_SUM);
+    comm.all_reduce(mine.data(),max.data(),n,MPI_MAX);
+    auto min = mine;
+    comm.all_reduce(min.data(),n,MPI_MIN);
+    for (int i=0; i<n; ++i) {
+      for (int k=0; k<N; ++k) {
+        REQUIRE (sum[i][k]==100*size*(size-1)/2 + size*(i*N+k));
+        REQUIRE (max[i][k]==(size-1)*100 + i*N + k);
+        REQUIRE (min[i][k]==i*N + k);
+      }
+    }
+  }
+
+  SECTION ("all_gather") {
+    comm.all_gather(mine.data(),all.data(),n);
+    for (int pid=0; pid<size; ++pid) {
+      for (int i=0; i<n; ++i) {
+        for (int k=0; k<N; ++k) {
+          REQUIRE (all[pid*n+i][k]==pid*100 + i*N + k);
+        }
+      }
+    }
+  }
+}
+
+template<typename DeviceT>
+void test_view_collectives (const ekat::Comm& comm) {
+  using view_2d = Kokkos::View<PackT**,DeviceT>;
+  using view_3d = Kokkos::View<PackT***,DeviceT>;
+
+  const int rank = comm.rank();
+  const int size = comm.size();
+  const int n0 = 2;
+  const int n1 = 3;
+  constexpr int N = PackT::n;
+
+  auto value = [] (const int pid, const int i, const int j, const int k) {
+    return pid*1000 + (i*n1+j)*N + k;
+  };
+
+  view_2d v("v",n0,n1);
+  auto v_h = Kokkos::create_mirror_view(v);
+  for (int i=0; i<n0; ++i) {
+    for (int j=0; j<n1; ++j) {
+      for (int k=0; k<N; ++k) {
+        v_h(i,j)[k] = value(rank,i,j,k);
+      }
+    }
+  }
+  Kokkos::deep_copy(v,v_h);
+
+  SECTION ("broadcast") {
+    ekat::broadcast(comm,v,size-1);
+    Kokkos::deep_copy(v_h,v);
+    for (int i=0; i<n0; ++i) {
+      for (int j=0; j<n1; ++j) {
+        for (int k=0; k<N; ++k) {
+          REQUIRE (v_h(i,j)[k]==value(size-1,i,j,k));
+        }
+      }
+    }
+  }
+
+  SECTION ("all_reduce") {
+    view_2d sum("sum",n0,n1);
+    typename view_2d::const_type v_c = v;
+    ekat::all_reduce(comm,v_c,sum,MPI_SUM);
+    ekat::all_reduce(comm,v,MPI_MAX);
+
+    auto sum_h = Kokkos::create_mirror_view(sum);
+    Kokkos::deep_copy(sum_h,sum);
+    Kokkos::deep_copy(v_h,v);
+    for (int i=0; i<n0; ++i) {
+      for (int j=0; j<n1; ++j) {
+        for (int k=0; k<N; ++k) {
+          REQUIRE (sum_h(i,j)[k]==1000*size*(size-1)/2 + size*value(0,i,j,k));
+          REQUIRE (v_h(i,j)[k]==value(size-1,i,j,k));
+        }
+      }
+    }
+  }
+
+  SECTION ("all_gather") {
+    view_3d all("all",size,n0,n1);
+    ekat::all_gather(comm,v,all);
+
+    auto all_h = Kokkos::create_mirror_view(all);
+    Kokkos::deep_copy(all_h,all);
+    for (int pid=0; pid<size; ++pid) {
+      for (int i=0; i<n0; ++i) {
+        for (int j=0; j<n1; ++j) {
+          for (int k=0; k<N; ++k) {
+            REQUIRE (all_h(pid,i,j)[k]==value(pid,i,j,k));
+          }
+        }
+      }
+    }
+  }
+
+  SECTION ("errors") {
+    view_2d wrong("wrong",n0,n1+1);
+    REQUIRE_THROWS (ekat::all_reduce(comm,v,wrong,MPI_SUM));
+    REQUIRE_THROWS (ekat::all_gather(comm,v,wrong));
+  }
+}
+
+TEST_CASE ("view_collectives") {
+  ekat::Comm comm(MPI_COMM_WORLD);
+
+  SECTION ("device") {
+    test_view_collectives<ekat::DefaultDevice>(comm);
+  }
+  SECTION ("host") {
+    test_view_collectives<ekat::HostDevice>(comm);
+  }
+}
+
+} // anonymous namespace
@@ -0,0 +1,95 @@
+#include <catch2/catch.hpp>
+#include "ekat/mpi/ekat_comm.hpp"
+
+#include <sstream>
+#include <vector>
+
+namespace {
+
+TEST_CASE ("comm_stats") {
+  using namespace ekat;
+
+  Comm comm(MPI_COMM_WORLD);
+  const int size = comm.size();
+  const auto& stats = get_comm_stats();
+
+  reset_comm_stats();
+  std::vector<double> vals(10,1.0);
+
+  SECTION ("disabled") {
+    comm.all_reduce(vals.data(),vals.size(),MPI_SUM);
+    comm.barrier();
+    REQUIRE (stats.empty());
+  }
+
+  SECTION ("enabled") {
+    enable_comm_stats();
+
+    comm.all_reduce(vals.data(),vals.size(),MPI_SUM);
+    {
+      CommStatsRegion outer("outer");
+      comm.all_reduce(vals.data(),vals.size(),MPI_SUM);
+      comm.all_reduce(vals.data(),5,MPI_SUM);
+      {
+        CommStatsRegion inner("inner");
+        comm.barrier();
+        auto req = comm.ibroadcast(vals.data(),3,0);
+        req.wait();
+      }
+      // Nested collectives are only recorded as part of the outer call
+      comm.all_gather_counts(1);
+    }
+    enable_comm_stats(false);
+    comm.barrier();
+
+    REQUIRE (stats.at("all_reduce").count==1);
+    REQUIRE (stats.at("all_reduce").bytes==10*sizeof(double));
+    REQUIRE (stats.at("outer/all_reduce").count==2);
+    REQUIRE (stats.at("outer/all_reduce").bytes==15*sizeof(double));
+    REQUIRE (stats.at("outer/inner/barrier").count==1);
+    REQUIRE (stats.at("outer/inner/ibroadcast").bytes==3*sizeof(double));
+    REQUIRE (stats.at("outer/all_gather_counts").count==1);
+    REQUIRE (stats.count("outer/all_gather")==0);
+    REQUIRE (stats.count("barrier")==0);
+#ifdef EKAT_ENABLE_MPI
+    REQUIRE (stats.size()==6);
+    REQUIRE (stats.at("outer/inner/wait").count==1);
+#else
+    // Without MPI, requests are already complete, so there is nothing to wait for
+    REQUIRE (stats.size()==5);
+#endif
+    for (const auto& it : stats) {
+      REQUIRE (it.second.seconds>=0);
+    }
+
+    // Some ranks record entries that others do not have
+    if (comm.am_i_root()) {
+      enable_comm_stats();
+      {
+        CommStatsRegion root_only("root_only");
+        Comm(MPI_COMM_SELF).barrier();
+      }
+      enable_comm_stats(false);
+    }
+
+    std::ostringstream out;
+    print_comm_stats(comm,out);
+
+    // The report does not record its own collectives
+    REQUIRE (stats.count("all_gather_counts")==0);
+
+    if (comm.am_i_root()) {
+      const auto report = out.str();
+      REQUIRE (report.find("on " + std::to_string(size) + " ranks")!=std::string::npos);
+      for (const auto& name : {"outer/all_reduce", "outer/inner/barrier", "root_only/barrier", "total"}) {
+        REQUIRE (report.find(name)!=std::string::npos);
+      }
+    } else {
+      REQUIRE (out.str().empty());
+    }
+  }
+
+  reset_comm_stats();
+}
+
+} // anonymous namespace
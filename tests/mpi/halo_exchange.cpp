@@ -0,0 +1,134 @@
+#include <catch2/catch.hpp>
+
+#include "ekat/mpi/ekat_halo_exchange.hpp"
+
+#include <algorithm>
+#include <map>
+#include <utility>
+#include <vector>
+
+namespace {
+
+// A periodic 1d domain, where each rank owns n consecutive global entries,
+// and stores one halo entry on each side: [left_halo, owned..., right_halo].
+struct Ring {
+  Ring (const ekat::Comm& comm, const int n)
+   : n(n), rank(comm.rank()), size(comm.size()), N(n*comm.size())
+  {}
+
+  int owner (const int gid) const { return gid / n; }
+  int left_halo (const int pid) const { return (pid*n-1+N) % N; }
+  int right_halo (const int pid) const { return ((pid+1)*n) % N; }
+  int num_local () const { return n+2; }
+  int owned_lid (const int gid) const { return gid - rank*n + 1; }
+
+  int gid (const int lid) const {
+    return lid==0 ? left_halo(rank) : (lid==n+1 ? right_halo(rank) : rank*n+lid-1);
+  }
+
+  // Register neighbors, sorting the entries exchanged with each neighbor by gid,
+  // so that senders and receivers agree on the order.
+  template<typename HaloExchange>
+  void add_neighbors (HaloExchange& halo) const {
+    std::map<int,std::vector<std::pair<int,int>>> sends, recvs;
+    recvs[owner(left_halo(rank))].emplace_back(left_halo(rank),0);
+    recvs[owner(right_halo(rank))].emplace_back(right_halo(rank),n+1);
+    for (int pid=0; pid<size; ++pid) {
+      for (int g : {left_halo(pid), right_halo(pid)}) {
+        if (owner(g)==rank) {
+          sends[pid].emplace_back(g,owned_lid(g));
+        }
+      }
+    }
+
+    auto lids = [](std::vector<std::pair<int,int>>& gid_lid) {
+      std::sort(gid_lid.begin(),gid_lid.end());
+      std::vector<int> v;
+      for (const auto& it : gid_lid) {
+        v.push_back(it.second);
+      }
+      return v;
+    };
+    for (auto& it : sends) {
+      halo.add_neighbor(it.first,lids(it.second),lids(recvs[it.first]));
+    }
+  }
+
+  int n, rank, size, N;
+};
+
+TEST_CASE ("halo_exchange") {
+  using namespace ekat;
+  using HE = HaloExchange<double>;
+  using KT = HE::KT;
+
+  Comm comm(MPI_COMM_WORLD);
+  Ring ring(comm,5);
+  const int nlocal = ring.num_local();
+
+  SECTION ("errors") {
+    HE halo(comm);
+    KT::view_1d<double> f("",nlocal);
+    REQUIRE_THROWS (halo.exchange(f));
+    REQUIRE_THROWS (halo.add_neighbor(comm.size(),{},{}));
+    REQUIRE_THROWS (halo.add_neighbor(comm.rank(),{-1},{0}));
+    halo.add_neighbor(comm.rank(),{},{});
+    REQUIRE_THROWS (halo.add_neighbor(comm.rank(),{},{}));
+    REQUIRE_THROWS (halo.setup(0));
+    halo.setup(2);
+    REQUIRE_THROWS (halo.setup(2));
+    REQUIRE_THROWS (halo.exchange(f));
+    REQUIRE_THROWS (halo.finish(KT::view_2d<double>("",nlocal,2)));
+  }
+
+  SECTION ("rank1") {
+    HE halo(comm);
+    ring.add_neighbors(halo);
+    halo.setup();
+    REQUIRE (halo.is_setup());
+
+    KT::view_1d<double> f("",nlocal);
+    auto fh = Kokkos::create_mirror_view(f);
+    for (int it=0; it<3; ++it) {
+      // Halos are garbage before the exchange
+      for (int lid=0; lid<nlocal; ++lid) {
+        fh(lid) = (lid==0 || lid==nlocal-1) ? -1 : ring.gid(lid)+it;
+      }
+      Kokkos::deep_copy(f,fh);
+      halo.exchange(f);
+      Kokkos::deep_copy(fh,f);
+      for (int lid=0; lid<nlocal; ++lid) {
+        REQUIRE (fh(lid)==ring.gid(lid)+it);
+      }
+    }
+  }
+
+  SECTION ("rank2") {
+    const int ncomps = 3;
+    HE halo(comm);
+    ring.add_neighbors(halo);
+    halo.setup(ncomps);
+    REQUIRE (halo.num_comps()==ncomps);
+
+    KT::view_2d<double> f("",nlocal,ncomps);
+    auto fh = Kokkos::create_mirror_view(f);
+    for (int lid=0; lid<nlocal; ++lid) {
+      for (int c=0; c<ncomps; ++c) {
+        fh(lid,c) = (lid==0 || lid==nlocal-1) ? -1 : 10*ring.gid(lid)+c;
+      }
+    }
+    Kokkos::deep_copy(f,fh);
+
+    // Split exchange
+    halo.start(f);
+    halo.finish(f);
+    Kokkos::deep_copy(fh,f);
+    for (int lid=0; lid<nlocal; ++lid) {
+      for (int c=0; c<ncomps; ++c) {
+        REQUIRE (fh(lid,c)==10*ring.gid(lid)+c);
+      }
+    }
+  }
+}
+
+} // anonymous namespace
@@ -0,0 +1,141 @@
+#include <catch2/catch.hpp>
+
+#include "ekat/mpi/ekat_reproducible_sum.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <vector>
+
+namespace {
+
+bool same_bits (const double a, const double b) {
+  return std::memcmp(&a,&b,sizeof(double))==0;
+}
+
+double sum_of (const std::vector<double>& v) {
+  ekat::ReproducibleSum s;
+  s.add(v.data(),v.size());
+  return s.value();
+}
+
+// Values spanning many orders of magnitude, with both signs, which makes
+// the result of a plain floating point sum very sensitive to the order.
+std::vector<double> make_values (const int n, const int seed) {
+  std::mt19937_64 engine(seed);
+  std::uniform_real_distribution<double> mant(-1,1);
+  std::uniform_int_distribution<int> exp(-40,40);
+  std::vector<double> v(n);
+  for (auto& x : v) {
+    x = std::ldexp(mant(engine),exp(engine));
+  }
+  return v;
+}
+
+TEST_CASE ("reproducible_sum_local") {
+  using namespace ekat;
+  constexpr double inf = std::numeric_limits<double>::infinity();
+  constexpr double dmax = std::numeric_limits<double>::max();
+  constexpr double dmin = std::numeric_limits<double>::denorm_min();
+
+  SECTION ("exact") {
+    REQUIRE (sum_of({})==0);
+    REQUIRE (sum_of({1e16,1,-1e16})==1);
+    REQUIRE (sum_of({1,1e100,1,-1e100})==2);
+    REQUIRE (sum_of({-3.5,1.25})==-2.25);
+
+    // The naive sum of ten 0.1 is 0.9999999999999999
+    REQUIRE (sum_of(std::vector<double>(10,0.1))==1.0);
+
+    // Subnormals, and extremes of the range
+    REQUIRE (sum_of({dmin,dmin})==2*dmin);
+    REQUIRE (sum_of({dmin,-dmin})==0);
+    REQUIRE (sum_of({dmax,1,-dmax})==1);
+    REQUIRE (sum_of({dmax,dmax,-dmax})==dmax);
+    REQUIRE (sum_of({dmax,dmax})==inf);
+    REQUIRE (sum_of({-dmax,-dmax})==-inf);
+    REQUIRE (sum_of({dmax,dmin})==dmax);
+    REQUIRE (sum_of({1,dmin})==1);
+  }
+
+  SECTION ("rounding") {
+    // Ties round to even
+    const double ulp = std::ldexp(1.0,-52);
+    REQUIRE (sum_of({1,ulp/2})==1);
+    REQUIRE (sum_of({1+ulp,ulp/2})==1+2*ulp);
+    // Just above a tie rounds up, thanks to the sticky bit
+    REQUIRE (sum_of({1,ulp/2,dmin})==1+ulp);
+    REQUIRE (sum_of({-1,-ulp/2,-dmin})==-1-ulp);
+  }
+
+  SECTION ("inf_nan") {
+    REQUIRE (sum_of({1,inf})==inf);
+    REQUIRE (sum_of({1,-inf})==-inf);
+    REQUIRE (std::isnan(sum_of({inf,-inf})));
+    REQUIRE (std::isnan(sum_of({1,std::nan("")})));
+  }
+
+  SECTION ("order_independent") {
+    auto v = make_values(10000,1);
+    const double ref = sum_of(v);
+
+    // Compare with a (very accurate) long double sum of the sorted values
+    auto sorted = v;
+    std::sort(sorted.begin(),sorted.end(),[](double a, double b){ return std::abs(a)<std::abs(b); });
+    long double ld = 0;
+    for (auto x : sorted) {
+      ld += x;
+    }
+    REQUIRE (std::abs(ref-static_cast<double>(ld))<=std::abs(ref)*1e-15);
+
+    std::mt19937_64 engine(2);
+    for (int i=0; i<5; ++i) {
+      std::shuffle(v.begin(),v.end(),engine);
+      REQUIRE (same_bits(sum_of(v),ref));
+    }
+
+    // Merging partial sums also gives the same result
+    ReproducibleSum s1, s2;
+    s1.add(v.data(),3000);
+    s2.add(v.data()+3000,v.size()-3000);
+    s2 += s1;
+    REQUIRE (same_bits(s2.value(),ref));
+  }
+}
+
+TEST_CASE ("reproducible_sum_global") {
+  using namespace ekat;
+
+  Comm comm(MPI_COMM_WORLD);
+  const int rank = comm.rank();
+  const int size = comm.size();
+
+  // Split the same global values across ranks, in uneven chunks
+  const int n = 10007;
+  const auto all = make_values(n,3);
+  const int beg = static_cast<long long>(n)*rank*rank/(size*size);
+  const int end = static_cast<long long>(n)*(rank+1)*(rank+1)/(size*size);
+
+  // The global sum must match the one computed on a single rank
+  const double ref = sum_of(all);
+  const double sum = reproducible_sum(comm,all.data()+beg,end-beg);
+  REQUIRE (same_bits(sum,ref));
+
+  // Several sums at once, with hierarchical collectives too
+  Comm hcomm(MPI_COMM_WORLD);
+  hcomm.set_collective_mode(Comm::CollectiveMode::Hierarchical);
+  std::vector<ReproducibleSum> sums(3);
+  for (int i=beg; i<end; ++i) {
+    sums[0] += all[i];
+    sums[1] += -all[i];
+    sums[2] += 2*all[i];
+  }
+  reproducible_sum(hcomm,sums.data(),sums.size());
+  REQUIRE (same_bits(sums[0].value(),ref));
+  REQUIRE (same_bits(sums[1].value(),-ref));
+  REQUIRE (same_bits(sums[2].value(),2*ref));
+}
+
+} // anonymous namespace
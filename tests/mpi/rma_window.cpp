@@ -0,0 +1,104 @@
+#include <catch2/catch.hpp>
+
+#include "ekat/mpi/ekat_rma_window.hpp"
+
+#include <vector>
+
+namespace {
+
+TEST_CASE ("rma_window") {
+  using namespace ekat;
+
+  Comm comm(MPI_COMM_WORLD);
+  const int rank = comm.rank();
+  const int size = comm.size();
+  const int next = (rank+1) % size;
+  const int prev = (rank+size-1) % size;
+  const int n = 4;
+
+  RmaWindow<double> win(comm,n);
+  const auto& v = win.view();
+  REQUIRE (v.extent(0)==n);
+
+  SECTION ("fence") {
+    // Sparse update of the next rank, and contiguous update of this rank
+    const std::vector<int>    offsets = {0, 2};
+    const std::vector<double> sparse  = {1, double(rank)};
+    const std::vector<double> dense   = {10, 10};
+
+    win.fence();
+    win.accumulate(next,offsets.data(),sparse.data(),2,MPI_SUM);
+    win.accumulate(rank,1,dense.data(),2,MPI_SUM);
+    win.fence();
+
+    REQUIRE (v(0)==1);
+    REQUIRE (v(1)==10);
+    REQUIRE (v(2)==prev+10);
+    REQUIRE (v(3)==0);
+
+    // Read the entries of the previous rank
+    std::vector<double> vals(n);
+    win.get(prev,0,vals.data(),n);
+    win.fence();
+    const int prev_prev = (prev+size-1) % size;
+    REQUIRE (vals[0]==1);
+    REQUIRE (vals[1]==10);
+    REQUIRE (vals[2]==prev_prev+10);
+    REQUIRE (vals[3]==0);
+  }
+
+  SECTION ("lock_all") {
+    // All ranks add to (and take the max with) entries of all ranks
+    const double one = 1;
+    const double r = rank;
+    win.lock_all();
+    for (int pid=0; pid<size; ++pid) {
+      win.accumulate(pid,3,&one,1,MPI_SUM);
+      win.accumulate(pid,0,&r,1,MPI_MAX);
+    }
+    win.flush_all();
+    win.unlock_all();
+    win.fence();
+
+    REQUIRE (v(0)==size-1);
+    REQUIRE (v(3)==size);
+
+    // Read sparse entries of the next rank
+    const std::vector<int> offsets = {3, 0, 1};
+    std::vector<double> vals(3);
+    win.lock_all();
+    win.get(next,offsets.data(),vals.data(),3);
+    win.flush(next);
+    win.unlock_all();
+    REQUIRE (vals[0]==size);
+    REQUIRE (vals[1]==size-1);
+    REQUIRE (vals[2]==0);
+  }
+
+  SECTION ("user_view") {
+    RmaWindow<int>::view_type data("data",2);
+    data(0) = rank;
+    RmaWindow<int> iwin(comm,data);
+    REQUIRE (iwin.view().data()==data.data());
+
+    const int val = 1;
+    iwin.fence();
+    iwin.accumulate(next,1,&val,1,MPI_SUM);
+    iwin.fence();
+    REQUIRE (data(0)==rank);
+    REQUIRE (data(1)==1);
+  }
+
+  SECTION ("errors") {
+    double val = 0;
+    REQUIRE_THROWS (win.accumulate(size,0,&val,1,MPI_SUM));
+    REQUIRE_THROWS (win.get(-1,0,&val,1));
+    REQUIRE_THROWS (win.unlock_all());
+    REQUIRE_THROWS (win.flush_all());
+    win.lock_all();
+    REQUIRE_THROWS (win.lock_all());
+    win.unlock_all();
+  }
+}
+
+} // anonymous namespace
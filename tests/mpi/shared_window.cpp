@@ -0,0 +1,99 @@
+#include <catch2/catch.hpp>
+
+#include "ekat/mpi/ekat_shared_window.hpp"
+
+namespace {
+
+TEST_CASE ("split_shared") {
+  using namespace ekat;
+
+  Comm comm(MPI_COMM_WORLD);
+  auto node = comm.split_shared();
+  auto leaders = comm.split_node_leaders();
+  node.own_mpi_comm();
+  leaders.own_mpi_comm();
+
+  REQUIRE (node.size()<=comm.size());
+
+  // Ranks keep their relative order, so the root is a node leader
+  const int rank = comm.rank();
+  int first;
+  node.all_reduce(&rank,&first,1,MPI_MIN);
+  REQUIRE (node.am_i_root()==(first==comm.rank()));
+  if (comm.am_i_root()) {
+    REQUIRE (node.am_i_root());
+    REQUIRE (leaders.am_i_root());
+  }
+
+  // Each node has one leader, and the leaders comm contains all of them
+  int num_nodes = node.am_i_root() ? 1 : 0;
+  comm.all_reduce(&num_nodes,1,MPI_SUM);
+  if (node.am_i_root()) {
+    REQUIRE (leaders.size()==num_nodes);
+  }
+
+  // The node sizes add up to the comm size
+  int sum_sizes = node.am_i_root() ? node.size() : 0;
+  comm.all_reduce(&sum_sizes,1,MPI_SUM);
+  REQUIRE (sum_sizes==comm.size());
+}
+
+TEST_CASE ("shared_window") {
+  using namespace ekat;
+
+  Comm comm(MPI_COMM_WORLD);
+  const int nrows = 10;
+  const int ncols = 3;
+
+  SECTION ("fill_on_leader") {
+    SharedWindow<int**> table(comm,nrows,ncols);
+    const auto& v = table.view();
+    REQUIRE (v.extent(0)==nrows);
+    REQUIRE (v.extent(1)==ncols);
+
+    if (table.am_i_node_leader()) {
+      for (int i=0; i<nrows; ++i) {
+        for (int j=0; j<ncols; ++j) {
+          v(i,j) = i*ncols+j;
+        }
+      }
+    }
+    table.fence();
+
+    for (int i=0; i<nrows; ++i) {
+      for (int j=0; j<ncols; ++j) {
+        REQUIRE (v(i,j)==i*ncols+j);
+      }
+    }
+
+    // All ranks on the node see the same memory
+    const auto& node = table.get_node_comm();
+    table.fence();
+    if (node.rank()==node.size()-1) {
+      v(0,0) = -1;
+    }
+    table.fence();
+    REQUIRE (v(0,0)==-1);
+  }
+
+  SECTION ("broadcast_from_root") {
+    SharedWindow<double*[3]> table(comm,nrows);
+    const auto& v = table.view();
+    if (comm.am_i_root()) {
+      for (int i=0; i<nrows; ++i) {
+        for (int j=0; j<3; ++j) {
+          v(i,j) = 0.5*(i*3+j);
+        }
+      }
+    }
+    table.broadcast_from_root();
+
+    for (int i=0; i<nrows; ++i) {
+      for (int j=0; j<3; ++j) {
+        REQUIRE (v(i,j)==0.5*(i*3+j));
+      }
+    }
+  }
+}
+
+} // anonymous namespace
@@ -7,6 +7,7 @@
 #include "ekat_test_config.h"
 
 #include <vector>
+#include <algorithm>
 
 namespace {
 
@@ -219,6 +220,102 @@ TEST_CASE("repack", "ekat::pack") {
   }
 }
 
+TEST_CASE("scalarize_repack_generic", "ekat::pack") {
+  using ekat::Pack;
+  using ekat::scalarize;
+  using ekat::repack;
+
+  // Use host views, so we can check values directly
+  using HS = Kokkos::HostSpace;
+
+  SECTION ("high_rank") {
+    Kokkos::View<Pack<double,4>*****,HS> a5("a5",2,3,1,2,3);
+    fill(a5);
+    const auto s5 = scalarize(a5);
+    static_assert(decltype(s5)::Rank==5, "Rank");
+    REQUIRE(s5.extent_int(4) == 12);
+    REQUIRE(s5(1,2,0,1,7) == a5(1,2,0,1,1)[3]);
+
+    Kokkos::View<Pack<double,2>*******,HS> a7("a7",2,1,2,1,2,1,3);
+    fill(a7);
+    const auto r7 = repack<1>(a7);
+    const auto s7 = scalarize(a7);
+    REQUIRE(r7.extent_int(6) == 6);
+    REQUIRE(s7.extent_int(6) == 6);
+    REQUIRE(r7(1,0,1,0,1,0,5)[0] == s7(1,0,1,0,1,0,5));
+    REQUIRE(s7(1,0,1,0,1,0,5) == a7(1,0,1,0,1,0,2)[1]);
+  }
+
+  SECTION ("grow") {
+    Kokkos::View<Pack<double,4>**,HS> a("a",3,8);
+    fill(a);
+    const auto b = repack<16>(a);
+    REQUIRE(b.extent_int(0) == 3);
+    REQUIRE(b.extent_int(1) == 2);
+    compare(scalarize(a), scalarize(b));
+  }
+
+  SECTION ("layout_stride") {
+    Kokkos::View<Pack<double,8>***,HS> a("a",4,3,5);
+    fill(a);
+    const auto sub = Kokkos::subview(a,Kokkos::ALL(),1,Kokkos::ALL());
+    static_assert(std::is_same<typename decltype(sub)::array_layout,Kokkos::LayoutStride>::value,
+                  "Subview should be LayoutStride");
+
+    const auto s = scalarize(sub);
+    const auto r = repack<2>(sub);
+    REQUIRE(s.extent_int(0) == 4);
+    REQUIRE(s.extent_int(1) == 40);
+    REQUIRE(r.extent_int(1) == 20);
+    for (int i = 0; i < 4; ++i) {
+      for (int k = 0; k < 40; ++k) {
+        REQUIRE(s(i,k) == a(i,1,k/8)[k%8]);
+        REQUIRE(r(i,k/2)[k%2] == s(i,k));
+      }
+    }
+    // Aliasing, not copying
+    REQUIRE(s.data() == reinterpret_cast<double*>(sub.data()));
+
+    // Non-unit stride along the last dimension: cannot be reinterpreted, so
+    // the host entry point falls back to a copy
+    Kokkos::View<Pack<double,8>**,Kokkos::LayoutStride,HS> c("c",Kokkos::LayoutStride(4,10,5,2));
+    fill(c);
+    REQUIRE(not ekat::impl::is_reinterpretable<8,1>(c.layout(),2));
+    const auto sc = ekat::scalarize_or_copy(c);
+    REQUIRE(sc.data() != reinterpret_cast<double*>(c.data()));
+    for (int i = 0; i < 4; ++i) {
+      for (int k = 0; k < 40; ++k) {
+        REQUIRE(sc(i,k) == c(i,k/8)[k%8]);
+      }
+    }
+
+    // Last extent not divisible by 16/8: cannot be reinterpreted nor copied
+    REQUIRE(not ekat::impl::is_reinterpretable<8,16>(sub.layout(),2));
+    REQUIRE_THROWS(ekat::repack_or_copy<16>(sub));
+  }
+
+  SECTION ("copy_fallback") {
+    // The last dimension of a LayoutLeft view is not contiguous
+    Kokkos::View<Pack<double,4>**,Kokkos::LayoutLeft,HS> a("a",3,5);
+    fill(a);
+    const auto s = ekat::scalarize_or_copy(a);
+    const auto r = ekat::repack_or_copy<2>(a);
+    REQUIRE(s.extent_int(1) == 20);
+    REQUIRE(r.extent_int(1) == 10);
+    for (int i = 0; i < 3; ++i) {
+      for (int k = 0; k < 20; ++k) {
+        REQUIRE(s(i,k) == a(i,k/4)[k%4]);
+        REQUIRE(r(i,k/2)[k%2] == s(i,k));
+      }
+    }
+
+    // A LayoutRight view is reinterpreted
+    Kokkos::View<Pack<double,4>**,HS> b("b",3,5);
+    const auto sb = ekat::scalarize_or_copy(b);
+    REQUIRE(sb.data() == reinterpret_cast<double*>(b.data()));
+  }
+}
+
 TEST_CASE("kokkos_packs", "ekat::pack") {
   using namespace ekat;
 
@@ -791,6 +888,204 @@ TEST_CASE("host_device_packs_3d", "ekat::pack")
   host_device_packs_3d<int, int>(true);
 }
 
+template <typename T, typename SizeT=int>
+void host_device_packs_batched(bool transpose)
+{
+  using VTS = VectorT<T>;
+  using VT = typename VTS::type;
+
+  using KT = ekat::KokkosTypes<ekat::DefaultDevice>;
+  using PackT = ekat::Pack<T, 4>;
+  using Staging = ekat::HostDeviceStaging<PackT>;
+
+  using view_1d_t = typename KT::template view_1d<PackT>;
+  using view_2d_t = typename KT::template view_2d<PackT>;
+  using view_3d_t = typename KT::template view_3d<PackT>;
+
+  const std::vector<SizeT> dim1_sizes = {3, 4, 5};
+  const std::vector<SizeT> dim2_sizes = {13, 37, 59};
+  const std::vector<SizeT> dim3_sizes = {7, 9, 2};
+  const int nviews = dim1_sizes.size();
+
+  // Each view gets enough storage for the 3d case
+  std::vector<std::vector<VT>> in(nviews), out(nviews), ref(nviews);
+  std::vector<const T*> cptrs(nviews);
+  std::vector<T*> out_ptrs(nviews), ref_ptrs(nviews);
+  for (int n = 0; n < nviews; ++n) {
+    const int size = dim1_sizes[n]*dim2_sizes[n]*dim3_sizes[n];
+    in[n].resize(size);
+    out[n].resize(size);
+    ref[n].resize(size);
+    for (int k = 0; k < size; ++k) {
+      reinterpret_cast<T*>(in[n].data())[k] = VTS::get_value(k*(n+1));
+    }
+    cptrs[n] = reinterpret_cast<const T*>(in[n].data());
+    out_ptrs[n] = reinterpret_cast<T*>(out[n].data());
+    ref_ptrs[n] = reinterpret_cast<T*>(ref[n].data());
+  }
+
+  // Check that the round trip recovers the input data, and that it matches
+  // the round trip with the non-batched version.
+  auto check = [&](const std::vector<int>& sizes) {
+    for (int n = 0; n < nviews; ++n) {
+      for (int k = 0; k < sizes[n]; ++k) {
+        REQUIRE (out[n][k] == ref[n][k]);
+        REQUIRE (out[n][k] == in[n][k]);
+      }
+    }
+  };
+
+  // All ranks go through the same staging buffer, which grows as needed.
+  // NOTE: no SECTIONs here, since Catch would only run them on the first
+  //       instantiation of this function within the TEST_CASE.
+  Staging staging;
+
+  // 1d
+  {
+    std::vector<view_1d_t> views(nviews), ref_views(nviews);
+    ekat::host_to_device(cptrs, dim2_sizes, views, staging);
+    ekat::host_to_device(cptrs, dim2_sizes, ref_views);
+    std::vector<int> sizes(nviews);
+    for (int n = 0; n < nviews; ++n) {
+      sizes[n] = dim2_sizes[n];
+      REQUIRE (views[n].extent(0) == ref_views[n].extent(0));
+    }
+
+    ekat::device_to_host(out_ptrs, dim2_sizes, views, staging);
+    ekat::device_to_host(ref_ptrs, dim2_sizes, ref_views);
+    check(sizes);
+  }
+
+  // 2d
+  {
+    std::vector<view_2d_t> views(nviews), ref_views(nviews);
+    ekat::host_to_device(cptrs, dim1_sizes, dim2_sizes, views, staging, transpose);
+    ekat::host_to_device(cptrs, dim1_sizes, dim2_sizes, ref_views, transpose);
+    std::vector<int> sizes(nviews);
+    for (int n = 0; n < nviews; ++n) {
+      sizes[n] = dim1_sizes[n]*dim2_sizes[n];
+      REQUIRE (views[n].extent(0) == ref_views[n].extent(0));
+      REQUIRE (views[n].extent(1) == ref_views[n].extent(1));
+    }
+
+    ekat::device_to_host(out_ptrs, dim1_sizes, dim2_sizes, views, staging, transpose);
+    ekat::device_to_host(ref_ptrs, dim1_sizes, dim2_sizes, ref_views, transpose);
+    check(sizes);
+  }
+
+  // 3d
+  {
+    std::vector<view_3d_t> views(nviews), ref_views(nviews);
+    ekat::host_to_device(cptrs, dim1_sizes, dim2_sizes, dim3_sizes, views, staging, transpose);
+    ekat::host_to_device(cptrs, dim1_sizes, dim2_sizes, dim3_sizes, ref_views, transpose);
+    std::vector<int> sizes(nviews);
+    for (int n = 0; n < nviews; ++n) {
+      sizes[n] = dim1_sizes[n]*dim2_sizes[n]*dim3_sizes[n];
+      for (int r = 0; r < 3; ++r) {
+        REQUIRE (views[n].extent(r) == ref_views[n].extent(r));
+      }
+    }
+
+    ekat::device_to_host(out_ptrs, dim1_sizes, dim2_sizes, dim3_sizes, views, staging, transpose);
+    ekat::device_to_host(ref_ptrs, dim1_sizes, dim2_sizes, dim3_sizes, ref_views, transpose);
+    check(sizes);
+  }
+}
+
+TEST_CASE("host_device_packs_batched", "ekat::pack")
+{
+  host_device_packs_batched<bool>(false);
+  host_device_packs_batched<bool>(true);
+  host_device_packs_batched<int, size_t>(false);
+  host_device_packs_batched<int, size_t>(true);
+  host_device_packs_batched<double>(false);
+  host_device_packs_batched<double>(true);
+}
+
+TEST_CASE("host_device_packs_async", "ekat::pack")
+{
+  using KT = ekat::KokkosTypes<ekat::DefaultDevice>;
+  using ExeSpace = typename KT::ExeSpace;
+  using PackT = ekat::Pack<double, 8>;
+  using Staging = ekat::HostDeviceStaging<PackT>;
+  using view_2d_t = typename KT::template view_2d<PackT>;
+
+  const std::vector<int> dim1_sizes = {512, 256, 1024};
+  const std::vector<int> dim2_sizes = {72, 128, 33};
+  const int nviews = dim1_sizes.size();
+
+  std::vector<std::vector<double>> in(nviews), out(nviews);
+  std::vector<const double*> cptrs(nviews);
+  std::vector<double*> out_ptrs(nviews);
+  for (int n = 0; n < nviews; ++n) {
+    const int size = dim1_sizes[n]*dim2_sizes[n];
+    in[n].resize(size);
+    out[n].resize(size);
+    for (int k = 0; k < size; ++k) {
+      in[n][k] = k*(n+1);
+    }
+    cptrs[n] = in[n].data();
+    out_ptrs[n] = out[n].data();
+  }
+
+  ExeSpace exec;
+  Staging staging;
+  std::vector<view_2d_t> views(nviews);
+  for (const bool transpose : {false, true}) {
+    for (const size_t chunk_size : {0, 1, 64}) {
+      for (auto& v : out) {
+        std::fill(v.begin(), v.end(), -1);
+      }
+
+      auto h2d = ekat::host_to_device_async(exec, cptrs, dim1_sizes, dim2_sizes,
+                                            views, staging, transpose, chunk_size);
+      REQUIRE (h2d.pending());
+
+      // Kernels on the same instance are ordered after the transfer,
+      // so it's safe to modify the views before waiting.
+      for (int n = 0; n < nviews; ++n) {
+        const auto v = views[n];
+        const int n2 = v.extent(1);
+        Kokkos::parallel_for(Kokkos::RangePolicy<ExeSpace>(exec, 0, v.extent(0)*n2),
+                             KOKKOS_LAMBDA (const int idx) {
+          v(idx / n2, idx % n2) *= 2.0;
+        });
+      }
+      h2d.wait();
+      REQUIRE (!h2d.pending());
+
+      auto d2h = ekat::device_to_host_async(exec, out_ptrs, dim1_sizes, dim2_sizes,
+                                            views, staging, transpose, chunk_size);
+      REQUIRE (d2h.pending());
+
+      // All the copies are enqueued before returning, so that they overlap with
+      // the host work done before waiting: once the instance is idle, the host
+      // staging buffer must be up to date, even though wait() was not called.
+      exec.fence();
+      const auto dev_buf = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(),staging.device_buffer());
+      const auto host_buf = staging.host_buffer();
+      for (int n = 0; n < nviews; ++n) {
+        const size_t offset = staging.offset_of(views[n]);
+        const size_t npack = views[n].extent(1);
+        for (size_t k = 0; k < views[n].size(); ++k) {
+          // Skip the padding of the last pack in each row
+          for (int i = 0; i < PackT::n && static_cast<int>((k%npack)*PackT::n)+i < dim2_sizes[n]; ++i) {
+            REQUIRE (host_buf(offset+k)[i] == dev_buf(offset+k)[i]);
+          }
+        }
+      }
+
+      d2h.wait();
+
+      for (int n = 0; n < nviews; ++n) {
+        for (size_t k = 0; k < in[n].size(); ++k) {
+          REQUIRE (out[n][k] == 2*in[n][k]);
+        }
+      }
+    }
+  }
+}
+
 TEST_CASE("index_and_shift", "ekat::pack")
 {
   static constexpr int pack_size = 8;
@@ -2,6 +2,9 @@
 
 #include "ekat/util/ekat_factory.hpp"
 
+#include <thread>
+#include <vector>
+
 namespace {
 
 struct Base {
@@ -42,6 +45,49 @@ TEST_CASE("factory") {
   REQUIRE (one->foo()==1);
 
   REQUIRE_THROWS (factory.create("three"));
+  REQUIRE_THROWS_WITH (factory.create("ones"),Catch::Contains("Did you mean 'one'?"));
+}
+
+TEST_CASE("factory_concurrent") {
+  using namespace ekat;
+
+  struct Tag {};
+  using factory_t = Factory<Base,std::string,std::shared_ptr<Base>,Tag>;
+  auto& factory = factory_t::instance();
+  factory.register_product("one",[](const Tag) -> std::shared_ptr<Base> { return std::make_shared<Derived1>(); });
+
+  // Create products from several threads, while other products are registered
+  factory.enable_concurrent_access();
+  const int nthreads = 4;
+  const int n = 1000;
+  std::vector<int> results(n,0);
+  std::vector<std::thread> threads;
+  for (int t=0; t<nthreads; ++t) {
+    threads.emplace_back([&,t]() {
+      for (int i=t; i<n; i+=nthreads) {
+        results[i] = factory.create("one",Tag())->foo();
+      }
+    });
+  }
+  for (int i=0; i<100; ++i) {
+    factory.register_product("two",[](const Tag) -> std::shared_ptr<Base> { return std::make_shared<Derived2>(); },true);
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+  for (int i=0; i<n; ++i) {
+    REQUIRE (results[i]==1);
+  }
+  REQUIRE (factory.create("two",Tag())->foo()==2);
+  REQUIRE (not factory.register_product("two",[](const Tag) -> std::shared_ptr<Base> { return nullptr; }));
+
+  // Registered products are listed in sorted order
+  factory.register_product("b",[](const Tag) -> std::shared_ptr<Base> { return nullptr; });
+  factory.register_product("a",[](const Tag) -> std::shared_ptr<Base> { return nullptr; });
+  REQUIRE_THROWS_WITH (factory.create("zzz",Tag()),Catch::Contains("a, b, one, two"));
+
+  factory.clean_up();
+  REQUIRE (factory.register_size()==0);
 }
 
 } // empty namespace
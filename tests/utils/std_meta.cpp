@@ -23,3 +23,56 @@ TEST_CASE ("any") {
   ekat::any c (u);
   REQUIRE (ekat::any_cast<std::vector<int>>(a)==ekat::any_cast<std::vector<int>>(c));
 }
+
+TEST_CASE ("any_small_buffer") {
+
+  // Small trivially copyable types are stored by value: copies are independent
+  ekat::any a (3);
+  ekat::any b = a;
+  ekat::any_cast<int>(b) = 4;
+  REQUIRE (ekat::any_cast<int>(a)==3);
+  REQUIRE (ekat::any_cast<int>(b)==4);
+
+  b = a;
+  REQUIRE (ekat::any_cast<int>(b)==3);
+  b.reset<double>(2.5);
+  REQUIRE (b.isType<double>());
+  REQUIRE (ekat::any_cast<double>(b)==2.5);
+
+  // any_ptr_cast moves the value to the heap, and the pointer shares ownership of it
+  auto ptr = ekat::any_ptr_cast<int>(a);
+  *ptr = 5;
+  REQUIRE (ekat::any_cast<int>(a)==5);
+  REQUIRE (ekat::any_ptr_cast<int>(a)==ptr);
+
+  // Other types are shared among copies
+  std::vector<int> u = {1,2};
+  ekat::any c (u);
+  ekat::any d = c;
+  ekat::any_cast<std::vector<int>>(d).push_back(3);
+  REQUIRE (ekat::any_cast<std::vector<int>>(c).size()==3);
+
+  // Switching between small and large types
+  c = a;
+  REQUIRE (ekat::any_cast<int>(c)==5);
+  a = d;
+  REQUIRE (ekat::any_cast<std::vector<int>>(a).size()==3);
+
+  // The pointer outlives the value held by the any
+  REQUIRE (*ptr==5);
+  REQUIRE (ekat::any_cast<int>(c)==5);
+
+  // Moves leave the source empty, for both small and large types
+  ekat::any e (std::move(b));
+  REQUIRE (ekat::any_cast<double>(e)==2.5);
+  REQUIRE (b.content_ptr()==nullptr);
+  e = std::move(d);
+  REQUIRE (ekat::any_cast<std::vector<int>>(e).size()==3);
+  REQUIRE (d.content_ptr()==nullptr);
+
+  // Values can be moved into the any, rather than copied
+  std::vector<int> w (100,1);
+  const int* w_data = w.data();
+  e.reset<std::vector<int>>(std::move(w));
+  REQUIRE (ekat::any_cast<std::vector<int>>(e).data()==w_data);
+}
@@ -1,6 +1,11 @@
 #include <catch2/catch.hpp>
 
 #include "ekat/util/ekat_string_utils.hpp"
+#include "ekat/util/ekat_suggestion_index.hpp"
+
+#include <map>
+#include <unordered_map>
+#include <unordered_set>
 
 namespace {
 
@@ -34,6 +39,32 @@ TEST_CASE("string","string") {
     REQUIRE (upper==upper_case(lower));
   }
 
+  SECTION ("tokenize") {
+    std::string s = ";a;;bc;";
+    std::vector<std::string> expected = {"","a","","bc",""};
+    std::vector<std::string> tokens;
+    for (const auto& t : tokenize(s,";")) {
+      // Tokens point into the input string
+      REQUIRE ((t.data()>=s.data() && t.data()<=s.data()+s.size()));
+      tokens.push_back(t.str());
+    }
+    REQUIRE (tokens==expected);
+    REQUIRE (split(s,';')==expected);
+    REQUIRE (split("",';')==std::vector<std::string>{""});
+    REQUIRE_THROWS (tokenize(s,""));
+
+    tokens.clear();
+    for (const auto& t : tokenize_any("  a_b c__ ", " _")) {
+      tokens.push_back(t.str());
+    }
+    REQUIRE (tokens==std::vector<std::string>{"a","b","c"});
+    REQUIRE (tokenize_any("___","_").begin()==tokenize_any("___","_").end());
+
+    REQUIRE (trim_ref("**a*b**",'*')=="a*b");
+    REQUIRE (trim_ref("***",'*').empty());
+    REQUIRE (trim("   ")=="");
+  }
+
   SECTION ("starts_with") {
     std::string s = "hello world";
     REQUIRE (starts_with(s,"hello"));
@@ -89,6 +120,29 @@ TEST_CASE("string","string") {
     REQUIRE (cis1!=cis3);
     REQUIRE (cis4<=cis1);
     REQUIRE (cis4<cis1);
+
+    REQUIRE (caseInsensitiveEqualString("TrUe","true"));
+    REQUIRE (not caseInsensitiveEqualString("true","truth"));
+    REQUIRE (caseInsensitiveLessString("abc","ABD"));
+    REQUIRE (not caseInsensitiveLessString("ABC","abc"));
+    REQUIRE (caseInsensitiveLessEqualString("ABC","abc"));
+    REQUIRE (caseInsensitiveLessString("ab","ABC"));
+
+    // Hash is consistent with equality, so strings can be used in unordered containers
+    REQUIRE (caseInsensitiveHash("Field_1")==caseInsensitiveHash("fIELD_1"));
+    std::unordered_map<std::string,int,CaseInsensitiveHash,CaseInsensitiveEqual> m;
+    m["Surface_Pressure"] = 1;
+    m["surface_pressure"] = 2;
+    REQUIRE (m.size()==1);
+    REQUIRE (m.at("SURFACE_PRESSURE")==2);
+
+    std::unordered_set<CaseInsensitiveString> s = {cis1,cis2,cis3};
+    REQUIRE (s.size()==2);
+    REQUIRE (s.count(CaseInsensitiveString("FIELD_2"))==1);
+
+    std::map<std::string,int,CaseInsensitiveLess> om = {{"b",1},{"A",2},{"B",3}};
+    REQUIRE (om.size()==2);
+    REQUIRE (om.begin()->first=="A");
   }
 
   SECTION ("jaro_similarity") {
@@ -146,6 +200,12 @@ TEST_CASE("string","string") {
     REQUIRE (no_atomic.size()==5);
     REQUIRE (atomic_1.size()==5);
     REQUIRE (atomic_2.size()==4);
+
+    // Atomic tokens come first, and all occurrences are kept whole
+    auto atomic_3 = gather_tokens("a_bc d bc_e",delims,"bc");
+    REQUIRE (atomic_3==std::list<std::string>{"bc","bc","a","d","e"});
+    auto atomic_4 = gather_tokens("a_b_cd",delims,"cd");
+    REQUIRE (atomic_4==std::list<std::string>{"cd","a","b"});
   }
 
   // Jaccard (token-based) similarity test.
@@ -199,6 +259,51 @@ TEST_CASE("string","string") {
   }
 }
 
+TEST_CASE("suggestion_index") {
+  using namespace ekat;
+
+  std::vector<std::string> names;
+  for (int i=0; i<1000; ++i) {
+    names.push_back("field_" + std::to_string(i));
+  }
+  names.push_back("surface_pressure");
+  names.push_back("surface_temperature");
+  names.push_back("air_temperature");
+  names.push_back("T_mid");
+
+  SuggestionIndex index(names);
+  REQUIRE (index.size()==names.size());
+  index.add("T_mid");
+  REQUIRE (index.size()==names.size());
+
+  // Best match first, and no more than k matches
+  auto s = index.suggest("surface_temperatrue",2);
+  REQUIRE (s.size()==2);
+  REQUIRE (s[0]=="surface_temperature");
+  REQUIRE (s[1]=="surface_pressure");
+
+  // Comparisons are case insensitive
+  REQUIRE (index.suggest("t_MID",1)==std::vector<std::string>{"T_mid"});
+
+  // Results match a brute force search with Jaro-Winkler
+  const std::string query = "field_1234";
+  std::string best;
+  double best_sim = 0;
+  for (const auto& n : names) {
+    const double sim = jaro_winkler_similarity(query,n);
+    if (sim>best_sim) {
+      best_sim = sim;
+      best = n;
+    }
+  }
+  REQUIRE (index.suggest(query,1)==std::vector<std::string>{best});
+
+  // Nothing similar enough
+  REQUIRE (index.suggest("xyz").empty());
+  REQUIRE (index.did_you_mean("xyz")=="");
+  REQUIRE (index.did_you_mean("T_mod",1)=="Did you mean 'T_mid'?");
+}
+
 TEST_CASE("parse_nested_list") {
   std::string valid_1 = "[a]";
   std::string valid_2 = "{a,b}";
@@ -28,4 +28,36 @@ TEST_CASE("upper_bound", "soak") {
   }
 }
 
+TEST_CASE("upper_bound_pack", "soak") {
+  constexpr int N = 8;
+  std::default_random_engine generator;
+  std::uniform_int_distribution<int> size_dist(0,1000);
+  std::uniform_real_distribution<double> value_dist(0.0,1.0);
+
+  for (int r = 0; r < 1000; ++r) {
+    const int size = size_dist(generator);
+    std::vector<double> v(size);
+    for (int i = 0; i < size; ++i) {
+      v[i] = value_dist(generator);
+    }
+    std::sort(v.begin(), v.end());
+
+    // Include values outside of [v.front(),v.back()], as well as exact matches
+    ekat::Pack<double,N> search_vals;
+    for (int s = 0; s < N; ++s) {
+      search_vals[s] = 1.2*value_dist(generator) - 0.1;
+    }
+    if (size>0) {
+      search_vals[0] = v[size/2];
+    }
+
+    const double* begin = v.data();
+    const auto ub = ekat::upper_bound(begin, begin + size, search_vals);
+    for (int s = 0; s < N; ++s) {
+      const int expected = std::upper_bound(v.begin(), v.end(), search_vals[s]) - v.begin();
+      REQUIRE(ub[s] == expected);
+    }
+  }
+}
+
 } // empty namespace
@@ -141,6 +141,66 @@ TEST_CASE("parameter_list", "") {
   auto p_begin = src.params_names_cbegin();
   auto p_end   = src.params_names_cend();
   REQUIRE (std::next(p_begin,2)==p_end); // Two params
+
+  // Getters return references to the stored values, not to copies
+  src.get<int>("i") = 5;
+  REQUIRE (&src.get<int>("i")==&src.get<int>("i"));
+  const auto& csrc = src;
+  REQUIRE (&csrc.get<int>("i")==&src.get<int>("i"));
+  REQUIRE (csrc.get<int>("i")==5);
+  REQUIRE (src.get<int>("k",3)==3);
+  REQUIRE (&src.get<int>("k",4)==&src.get<int>("k"));
+  REQUIRE (src.get<int>("k")==3);
+  REQUIRE_THROWS (src.set<double>("k",1.0));
+  REQUIRE_THROWS (csrc.get<int>("missing"));
+}
+
+TEST_CASE("parameter_list_keys", "") {
+  using namespace ekat;
+  using Key = ParameterList::Key;
+  using KeyPath = ParameterList::KeyPath;
+
+  ParameterList pl("pl");
+  pl.sublist("a").sublist("b").set<int>("c",1);
+  for (int i=0; i<100; ++i) {
+    pl.set<int>("p" + std::to_string(i),i);
+  }
+
+  // Pre-resolved keys/paths
+  const Key p10("p10");
+  const KeyPath abc {"a","b","c"};
+  REQUIRE (pl.isParameter(p10));
+  REQUIRE (pl.get<int>(p10)==10);
+  REQUIRE (pl.isParameter(abc));
+  REQUIRE (not pl.isParameter(KeyPath{"a","x","c"}));
+  pl.get<int>(abc) = 2;
+  REQUIRE (pl.sublist("a").sublist("b").get<int>("c")==2);
+  REQUIRE (&pl.sublist(KeyPath{"a","b"})==&pl.sublist("a").sublist("b"));
+
+  const auto& cpl = pl;
+  REQUIRE (cpl.get<int>(abc)==2);
+  REQUIRE_THROWS (cpl.sublist("x"));
+  REQUIRE_THROWS (cpl.get<int>(Key("x")));
+
+  // Names are iterated in lexicographic order, regardless of insertion order
+  for (int i=0; i<100; ++i) {
+    REQUIRE (pl.get<int>("p" + std::to_string(i))==i);
+  }
+  std::string prev;
+  int count = 0;
+  for (auto it=pl.params_names_cbegin(); it!=pl.params_names_cend(); ++it, ++count) {
+    REQUIRE (prev < *it);
+    prev = *it;
+  }
+  REQUIRE (count==100);
+  REQUIRE (*std::prev(pl.params_names_cend())=="p99");
+
+  // Misspelled keys get suggestions in the error message
+  pl.set<int>("number_of_levels",72);
+  REQUIRE_THROWS_WITH (pl.get<int>("number_of_level"),Catch::Contains("Did you mean 'number_of_levels'?"));
+  REQUIRE_THROWS_WITH (pl.get<int>("zzz"),not Catch::Contains("Did you mean"));
+  pl.sublist("physics_params");
+  REQUIRE_THROWS_WITH (pl.get<int>("physic_params"),Catch::Contains("Did you mean 'physics_params'?"));
 }
 
 } // empty namespace